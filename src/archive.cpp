@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <istream>
+#include <ostream>
+#include <stdexcept>
+#include "./archive.hpp"
+
+/** The magic bytes every archive starts with */
+static const char MAGIC[4] = { 'B', 'N', 'R', 'Y' };
+
+/** The offset of the checksum in the header */
+static constexpr std::size_t CHECKSUM_OFFSET = 16;
+
+/**
+ * Stores the lowest `n` bytes of `value` to `out`, least significant byte first
+ */
+static void store_le(char* out, std::uint64_t value, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) {
+        out[i] = static_cast<char>(value >> (8 * i));
+    }
+}
+
+/**
+ * @returns the `n` byte little endian word at `in`
+ */
+static std::uint64_t load_le(const char* in, std::size_t n) {
+    std::uint64_t value = 0;
+    for (std::size_t i = n; i-- > 0; ) {
+        value = (value << 8) | static_cast<unsigned char>(in[i]);
+    }
+    return value;
+}
+
+/**
+ * Converts limbs between host byte order and the archive's little endian order, in place
+ */
+static void swap_limbs(std::uint64_t* a, std::size_t n) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    for (std::size_t i = 0; i < n; i++) {
+        a[i] = __builtin_bswap64(a[i]);
+    }
+#else
+    (void) a;
+    (void) n;
+#endif
+}
+
+/**
+ * @returns the number of limbs following a header of `bits` bits
+ */
+static std::uint64_t limbs_for(std::uint64_t bits) {
+    return bits / 64 + (bits % 64 != 0);
+}
+
+std::uint64_t archive::checksum(std::uint64_t h, const std::uint64_t* a, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) {
+        h = (h ^ a[i]) * 0x100000001b3;
+    }
+    return h;
+}
+
+archive::Header archive::parse_header(const char* bytes) {
+    if (!std::equal(MAGIC, MAGIC + 4, bytes)) {
+        throw std::invalid_argument("Not an archive, the magic bytes do not match");
+    }
+    const std::uint64_t version = load_le(bytes + 4, 4);
+    if (version != VERSION) {
+        throw std::invalid_argument("Archive has version " + std::to_string(version) + ", expected "
+                                    + std::to_string(VERSION));
+    }
+    const std::uint64_t bits = load_le(bytes + 8, 8);
+    const Header header { bits, limbs_for(bits), load_le(bytes + CHECKSUM_OFFSET, 8) };
+    if (!header.limbs && header.checksum != CHECKSUM_SEED) {
+        throw std::invalid_argument("Archive is corrupt, the checksum does not match");
+    }
+    return header;
+}
+
+/* Writer */
+
+archive::Writer::Writer(std::ostream& os, std::uint64_t bits, std::uint64_t sum)
+    : m_os { os }
+    , m_start { os.tellp() }
+    , m_limbs { limbs_for(bits) }
+    , m_written { 0 }
+    , m_known { true }
+    , m_sum { sum }
+{
+    char header[HEADER_SIZE];
+    std::copy(MAGIC, MAGIC + 4, header);
+    store_le(header + 4, VERSION, 4);
+    store_le(header + 8, bits, 8);
+    store_le(header + CHECKSUM_OFFSET, sum, 8);
+    if (!m_os.write(header, HEADER_SIZE)) {
+        throw std::runtime_error("Failed to write archive header");
+    }
+}
+
+archive::Writer::Writer(std::ostream& os, std::uint64_t bits) : Writer(os, bits, CHECKSUM_SEED) {
+    m_known = false;
+}
+
+void archive::Writer::write(const std::uint64_t* a, std::size_t n) {
+    if (n > m_limbs - m_written) {
+        throw std::length_error("Archive holds " + std::to_string(m_limbs) + " limbs, cannot write more");
+    }
+    if (!m_known) {
+        m_sum = checksum(m_sum, a, n);
+    }
+    m_written += n;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    std::uint64_t chunk[CHUNK_LIMBS];
+    for (std::size_t i = 0; i < n; i += CHUNK_LIMBS) {
+        const std::size_t len = std::min(CHUNK_LIMBS, n - i);
+        std::copy(a + i, a + i + len, chunk);
+        swap_limbs(chunk, len);
+        m_os.write(reinterpret_cast<const char*>(chunk), static_cast<std::streamsize>(8 * len));
+    }
+#else
+    for (std::size_t i = 0; i < n; i += CHUNK_LIMBS) {
+        const std::size_t len = std::min(CHUNK_LIMBS, n - i);
+        m_os.write(reinterpret_cast<const char*>(a + i), static_cast<std::streamsize>(8 * len));
+    }
+#endif
+    if (!m_os) {
+        throw std::runtime_error("Failed to write archive limbs");
+    }
+}
+
+void archive::Writer::finish() {
+    if (m_written != m_limbs) {
+        throw std::length_error("Archive holds " + std::to_string(m_limbs) + " limbs, only "
+                                + std::to_string(m_written) + " were written");
+    }
+    if (!m_known) {
+        if (m_start < 0) {
+            throw std::runtime_error("Cannot patch the archive's checksum, the stream is not seekable");
+        }
+        char sum[8];
+        store_le(sum, m_sum, 8);
+        const std::streampos end = m_os.tellp();
+        m_os.seekp(m_start + static_cast<std::streamoff>(CHECKSUM_OFFSET));
+        m_os.write(sum, 8);
+        m_os.seekp(end);
+        m_known = true;
+    }
+    if (!m_os.flush()) {
+        throw std::runtime_error("Failed to write archive");
+    }
+}
+
+/* Reader */
+
+archive::Reader::Reader(std::istream& is) : m_is { is }, m_header {}, m_read { 0 }, m_sum { CHECKSUM_SEED }
+{
+    char header[HEADER_SIZE];
+    if (!m_is.read(header, HEADER_SIZE)) {
+        throw std::invalid_argument("Archive is truncated, expected a header of " + std::to_string(HEADER_SIZE) + " bytes");
+    }
+    m_header = parse_header(header);
+}
+
+std::size_t archive::Reader::read(std::uint64_t* r, std::size_t n) {
+    n = static_cast<std::size_t>(std::min<std::uint64_t>(n, remaining()));
+    for (std::size_t i = 0; i < n; i += CHUNK_LIMBS) {
+        const std::size_t len = std::min(CHUNK_LIMBS, n - i);
+        if (!m_is.read(reinterpret_cast<char*>(r + i), static_cast<std::streamsize>(8 * len))) {
+            throw std::invalid_argument("Archive is truncated, expected " + std::to_string(m_header.limbs) + " limbs");
+        }
+    }
+    swap_limbs(r, n);
+    m_sum = checksum(m_sum, r, n);
+    m_read += n;
+    if (!remaining() && m_sum != m_header.checksum) {
+        throw std::invalid_argument("Archive is corrupt, the checksum does not match");
+    }
+    return n;
+}
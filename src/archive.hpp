@@ -0,0 +1,174 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ios>
+
+/**
+ * A compact, versioned on-disk format for numbers, storing their raw limbs
+ *
+ * An archive consists of a 24 byte header followed by the number's limbs, least significant first,
+ * each as 8 byte little endian word. All header fields are little endian as well:
+ *
+ *      offset  size  field
+ *      0       4     magic "BNRY"
+ *      4       4     format version (`VERSION`)
+ *      8       8     nominal number of bits, `ceil(bits / 64)` limbs follow (`0` for an *empty* number)
+ *      16      8     checksum of the limbs (see `checksum`)
+ *
+ * `Writer` and `Reader` transfer the limbs in chunks of the caller's choice, so numbers can be
+ * archived and restored w/o ever being buffered as a whole.
+ */
+namespace archive {
+
+    /** The version of the format written, readers reject other versions */
+    constexpr std::uint32_t VERSION = 1;
+
+    /** The size of the header in bytes */
+    constexpr std::size_t HEADER_SIZE = 24;
+
+    /** The number of limbs transferred per stream operation */
+    constexpr std::size_t CHUNK_LIMBS = 8192;
+
+    /**
+     * The initial value of the checksum, i.e. the checksum of no limbs
+     */
+    constexpr std::uint64_t CHECKSUM_SEED = 0xcbf29ce484222325;
+
+    /**
+     * Continues the checksum `h` over `n` limbs (64 bit FNV-1a, applied to whole limbs)
+     *
+     * @returns the checksum of all limbs fed so far
+     */
+    std::uint64_t checksum(std::uint64_t h, const std::uint64_t* a, std::size_t n);
+
+    /**
+     * The fields of an archive's header
+     */
+    struct Header {
+        /** The nominal number of bits */
+        std::uint64_t bits;
+
+        /** The number of limbs following the header */
+        std::uint64_t limbs;
+
+        /** The checksum of the limbs */
+        std::uint64_t checksum;
+    };
+
+    /**
+     * Parses and validates an archive's header
+     *
+     * @param bytes the first `HEADER_SIZE` bytes of the archive
+     * @throws std::invalid_argument if the header is malformed or of another version
+     */
+    Header parse_header(const char* bytes);
+
+    /**
+     * Writes an archive to an output stream, limbs are passed in chunks
+     *
+     * If the checksum is not known in advance, a placeholder is written and patched by `finish`,
+     * which requires a seekable stream.
+     */
+    class Writer {
+        public:
+        /**
+         * Writes the header of an archive w/ a known checksum
+         *
+         * @param os the stream to write to
+         * @param bits the nominal number of bits of the number
+         * @param sum the checksum of the number's limbs
+         * @throws std::runtime_error if writing fails
+         */
+        Writer(std::ostream& os, std::uint64_t bits, std::uint64_t sum);
+
+        /**
+         * Writes the header of an archive whose checksum is computed while writing
+         *
+         * @param os the (seekable) stream to write to
+         * @param bits the nominal number of bits of the number
+         * @throws std::runtime_error if writing fails
+         */
+        Writer(std::ostream& os, std::uint64_t bits);
+
+        /**
+         * Appends `n` limbs
+         *
+         * @throws std::length_error if more limbs are written than the bit length admits
+         * @throws std::runtime_error if writing fails
+         */
+        void write(const std::uint64_t* a, std::size_t n);
+
+        /**
+         * Completes the archive (patching the checksum if needed)
+         *
+         * @throws std::length_error if fewer limbs were written than the bit length requires
+         * @throws std::runtime_error if writing fails
+         */
+        void finish();
+
+        private:
+        std::ostream& m_os;
+
+        /** The position of the header, where the checksum is patched */
+        std::streamoff m_start;
+
+        /** The number of limbs the archive holds */
+        std::uint64_t m_limbs;
+
+        /** The number of limbs written so far */
+        std::uint64_t m_written;
+
+        /** Whether the checksum was written w/ the header, otherwise it is computed while writing */
+        bool m_known;
+
+        /** The checksum of the limbs written so far */
+        std::uint64_t m_sum;
+    };
+
+    /**
+     * Reads an archive from an input stream, limbs are retrieved in chunks
+     *
+     * The checksum is verified as soon as the last limb has been read.
+     */
+    class Reader {
+        public:
+        /**
+         * Reads and validates the header of an archive
+         *
+         * @param is the stream to read from
+         * @throws std::invalid_argument if the header is malformed, truncated or of another version
+         */
+        explicit Reader(std::istream& is);
+
+        /**
+         * @returns the nominal number of bits of the archived number
+         */
+        std::uint64_t bits() const { return m_header.bits; }
+
+        /**
+         * @returns the number of limbs of the archived number
+         */
+        std::uint64_t limbs() const { return m_header.limbs; }
+
+        /**
+         * @returns the number of limbs not read yet
+         */
+        std::uint64_t remaining() const { return m_header.limbs - m_read; }
+
+        /**
+         * Reads the next `min(n, remaining())` limbs to `r`
+         *
+         * @returns the number of limbs read
+         * @throws std::invalid_argument if the data is truncated or its checksum does not match
+         */
+        std::size_t read(std::uint64_t* r, std::size_t n);
+
+        private:
+        std::istream& m_is;
+        Header m_header;
+        std::uint64_t m_read;
+
+        /** The checksum of the limbs read so far */
+        std::uint64_t m_sum;
+    };
+}
@@ -0,0 +1,104 @@
+#include <algorithm>
+#include <new>
+#include "./arena.hpp"
+
+/** The arena installed for the current thread */
+static thread_local Arena* installed = nullptr;
+
+/** The alignment of every allocation, suitable for any fundamental type */
+static constexpr std::size_t ALIGN = alignof(std::max_align_t);
+
+/**
+ * Precedes every allocation of `arena::allocate`, padded so that the memory following it stays aligned
+ */
+struct alignas(std::max_align_t) Header {
+    /** Whether the memory was taken from an arena rather than the heap */
+    bool pooled;
+};
+
+/**
+ * @returns `n` rounded up to a multiple of `ALIGN`
+ */
+static std::size_t aligned(std::size_t n) {
+    return (n + ALIGN - 1) & ~(ALIGN - 1);
+}
+
+Arena::Arena(std::size_t block_bytes) : m_block { 0 }, m_offset { 0 }, m_used { 0 } {
+    const std::size_t size = aligned(std::max(block_bytes, ALIGN));
+    m_blocks.push_back({ static_cast<char*>(::operator new(size)), size });
+}
+
+Arena::~Arena() {
+    for (Block& block : m_blocks) {
+        ::operator delete(block.data);
+    }
+}
+
+void* Arena::allocate(std::size_t bytes) {
+    bytes = aligned(bytes);
+    while (m_offset + bytes > m_blocks[m_block].size) {
+        // the tail of a block that is too short is skipped until the next `reset`
+        m_used += m_blocks[m_block].size;
+        m_offset = 0;
+        if (++m_block == m_blocks.size()) {
+            const std::size_t size = std::max(bytes, 2 * m_blocks.back().size);
+            m_blocks.push_back({ static_cast<char*>(::operator new(size)), size });
+        }
+    }
+    void* p = m_blocks[m_block].data + m_offset;
+    m_offset += bytes;
+    return p;
+}
+
+void Arena::reset() {
+    m_block = 0;
+    m_offset = 0;
+    m_used = 0;
+}
+
+std::size_t Arena::used() const {
+    return m_used + m_offset;
+}
+
+std::size_t Arena::capacity() const {
+    std::size_t size = 0;
+    for (const Block& block : m_blocks) {
+        size += block.size;
+    }
+    return size;
+}
+
+Arena::Scope::Scope(Arena& arena) : m_previous { installed } {
+    installed = &arena;
+}
+
+Arena::Scope::~Scope() {
+    installed = m_previous;
+}
+
+Arena::Suspend::Suspend() : m_previous { installed } {
+    installed = nullptr;
+}
+
+Arena::Suspend::~Suspend() {
+    installed = m_previous;
+}
+
+Arena* arena::current() {
+    return installed;
+}
+
+void* arena::allocate(std::size_t bytes) {
+    Header* header = static_cast<Header*>(installed ? installed->allocate(sizeof(Header) + bytes) : ::operator new(sizeof(Header) + bytes));
+    header->pooled = installed != nullptr;
+    return header + 1;
+}
+
+void arena::deallocate(void* p) noexcept {
+    if (p) {
+        Header* header = static_cast<Header*>(p) - 1;
+        if (!header->pooled) {
+            ::operator delete(header);
+        }
+    }
+}
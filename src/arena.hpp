@@ -0,0 +1,163 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/**
+ * A monotonic arena for the short-lived allocations of evaluating an expression
+ *
+ * Allocations bump a pointer through a list of blocks and are never freed one by one, `reset`
+ * rewinds the arena as a whole instead and keeps its blocks for the next round. Once the blocks
+ * have grown to the needs of the expressions evaluated, evaluating another one does not touch the
+ * global heap at all.
+ *
+ * An arena is installed for the calling thread by an `Arena::Scope`, all limb storage (see
+ * `LimbVector`) and parser tokens allocated through `arena::allocate` while the scope is alive are
+ * taken from it. Other threads, e.g. the workers of the pool in `parallel.hpp`, keep allocating on
+ * the heap. Memory of an arena may be released after its scope has ended, but not after the arena
+ * has been reset or destroyed, so storage kept beyond the current expression must be allocated under
+ * an `Arena::Suspend`.
+ */
+class Arena {
+    public:
+    /** The size of the first block, later blocks double in size */
+    static constexpr std::size_t BLOCK_BYTES = std::size_t { 1 } << 16;
+
+    /**
+     * Creates an arena and allocates its first block
+     * @param block_bytes the size of the first block
+     */
+    explicit Arena(std::size_t block_bytes = BLOCK_BYTES);
+
+    Arena(const Arena&) = delete;
+
+    Arena& operator=(const Arena&) = delete;
+
+    /**
+     * Releases all blocks to the heap
+     */
+    ~Arena();
+
+    /**
+     * @returns `bytes` bytes aligned for any fundamental type, taken from the current block or a new one
+     */
+    void* allocate(std::size_t bytes);
+
+    /**
+     * Rewinds the arena to its first block, all memory handed out before becomes invalid
+     */
+    void reset();
+
+    /**
+     * @returns the number of bytes handed out since construction or the last `reset`
+     */
+    std::size_t used() const;
+
+    /**
+     * @returns the total size of the arena's blocks
+     */
+    std::size_t capacity() const;
+
+    /**
+     * Installs an arena for the calling thread for the lifetime of the scope, the previously
+     * installed arena (if any) is restored afterwards
+     */
+    class Scope {
+        public:
+        explicit Scope(Arena& arena);
+
+        Scope(const Scope&) = delete;
+
+        Scope& operator=(const Scope&) = delete;
+
+        ~Scope();
+
+        private:
+        Arena* m_previous;
+    };
+
+    /**
+     * Uninstalls the calling thread's arena for the lifetime of the guard, so that allocations which
+     * outlive any arena, e.g. process-wide caches, are taken from the heap; the arena is reinstalled
+     * afterwards
+     */
+    class Suspend {
+        public:
+        Suspend();
+
+        Suspend(const Suspend&) = delete;
+
+        Suspend& operator=(const Suspend&) = delete;
+
+        ~Suspend();
+
+        private:
+        Arena* m_previous;
+    };
+
+    private:
+    struct Block {
+        char* data;
+        std::size_t size;
+    };
+
+    std::vector<Block> m_blocks;
+
+    /** The index of the block allocations are currently taken from */
+    std::size_t m_block;
+
+    /** The number of bytes used of the current block */
+    std::size_t m_offset;
+
+    /** The number of bytes used of the blocks before the current one, including skipped tails */
+    std::size_t m_used;
+};
+
+/**
+ * Allocation functions routing to the calling thread's arena, or the heap if none is installed
+ *
+ * Every allocation is preceded by a small header recording where it came from, so that memory may
+ * be released from any thread and regardless of which arena is installed at that time.
+ */
+namespace arena {
+
+    /**
+     * @returns the arena installed for the calling thread, `nullptr` if there is none
+     */
+    Arena* current();
+
+    /**
+     * @returns `bytes` bytes aligned for any fundamental type
+     * @throws std::bad_alloc if the heap is exhausted
+     */
+    void* allocate(std::size_t bytes);
+
+    /**
+     * Releases memory obtained from `allocate`, which is a no-op for memory of an arena
+     * @param p the memory to release, may be `nullptr`
+     */
+    void deallocate(void* p) noexcept;
+
+    /**
+     * A stateless standard allocator using `allocate` and `deallocate`, for containers and
+     * `std::allocate_shared`
+     */
+    template<typename T>
+    struct Allocator {
+        using value_type = T;
+
+        Allocator() noexcept = default;
+
+        template<typename U>
+        Allocator(const Allocator<U>&) noexcept {}
+
+        T* allocate(std::size_t n) { return static_cast<T*>(arena::allocate(n * sizeof(T))); }
+
+        void deallocate(T* p, std::size_t) noexcept { arena::deallocate(p); }
+
+        template<typename U>
+        bool operator==(const Allocator<U>&) const noexcept { return true; }
+
+        template<typename U>
+        bool operator!=(const Allocator<U>&) const noexcept { return false; }
+    };
+}
@@ -0,0 +1,888 @@
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <vector>
+#include "./arith.hpp"
+#include "./parallel.hpp"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+/** Unsigned 128 bit integer used for full limb products */
+__extension__ typedef unsigned __int128 uint128;
+
+/** A number of variable length (least significant limb first) used for intermediate results */
+using Limbs = std::vector<std::uint64_t>;
+
+/**
+ * Computes `a + b + carry`
+ *
+ * @param out receives the low limb of the sum
+ * @returns the carry out (`0` or `1`)
+ */
+static inline std::uint64_t addc(std::uint64_t a, std::uint64_t b, std::uint64_t carry, std::uint64_t& out) {
+#if defined(__x86_64__)
+    unsigned long long int r;
+    const std::uint64_t c = _addcarry_u64(static_cast<unsigned char>(carry), a, b, &r);
+    out = r;
+    return c;
+#else
+    std::uint64_t s;
+    const bool c1 = __builtin_add_overflow(a, b, &s);
+    const bool c2 = __builtin_add_overflow(s, carry, &out);
+    return c1 | c2;
+#endif
+}
+
+/**
+ * Computes `a - b - borrow`
+ *
+ * @param out receives the low limb of the difference
+ * @returns the borrow out (`0` or `1`)
+ */
+static inline std::uint64_t subb(std::uint64_t a, std::uint64_t b, std::uint64_t borrow, std::uint64_t& out) {
+#if defined(__x86_64__)
+    unsigned long long int r;
+    const std::uint64_t c = _subborrow_u64(static_cast<unsigned char>(borrow), a, b, &r);
+    out = r;
+    return c;
+#else
+    std::uint64_t d;
+    const bool b1 = __builtin_sub_overflow(a, b, &d);
+    const bool b2 = __builtin_sub_overflow(d, borrow, &out);
+    return b1 | b2;
+#endif
+}
+
+std::uint64_t arith::add_n(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n) {
+    std::uint64_t carry = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        carry = addc(a[i], b[i], carry, r[i]);
+        carry = addc(a[i + 1], b[i + 1], carry, r[i + 1]);
+        carry = addc(a[i + 2], b[i + 2], carry, r[i + 2]);
+        carry = addc(a[i + 3], b[i + 3], carry, r[i + 3]);
+    }
+    for (; i < n; i++) {
+        carry = addc(a[i], b[i], carry, r[i]);
+    }
+    return carry;
+}
+
+std::uint64_t arith::add(std::uint64_t* r, const std::uint64_t* a, std::size_t an, const std::uint64_t* b, std::size_t bn) {
+    std::uint64_t carry = add_n(r, a, b, bn);
+    std::size_t i = bn;
+    for (; i < an && carry; i++) {
+        carry = addc(a[i], 0, carry, r[i]);
+    }
+    if (r != a) {
+        for (; i < an; i++) {
+            r[i] = a[i];
+        }
+    }
+    return carry;
+}
+
+std::uint64_t arith::sub_n(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n) {
+    std::uint64_t borrow = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        borrow = subb(a[i], b[i], borrow, r[i]);
+        borrow = subb(a[i + 1], b[i + 1], borrow, r[i + 1]);
+        borrow = subb(a[i + 2], b[i + 2], borrow, r[i + 2]);
+        borrow = subb(a[i + 3], b[i + 3], borrow, r[i + 3]);
+    }
+    for (; i < n; i++) {
+        borrow = subb(a[i], b[i], borrow, r[i]);
+    }
+    return borrow;
+}
+
+std::uint64_t arith::sub(std::uint64_t* r, const std::uint64_t* a, std::size_t an, const std::uint64_t* b, std::size_t bn) {
+    std::uint64_t borrow = sub_n(r, a, b, bn);
+    std::size_t i = bn;
+    for (; i < an && borrow; i++) {
+        borrow = subb(a[i], 0, borrow, r[i]);
+    }
+    if (r != a) {
+        for (; i < an; i++) {
+            r[i] = a[i];
+        }
+    }
+    return borrow;
+}
+
+/**
+ * Compares two numbers of `n` limbs each on the calling thread
+ */
+static int cmp_serial(const std::uint64_t* a, const std::uint64_t* b, std::size_t n) {
+    for (std::size_t i = n; i-- > 0; ) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+int arith::cmp_n(const std::uint64_t* a, const std::uint64_t* b, std::size_t n) {
+    if (!parallel::worthwhile(n)) {
+        return cmp_serial(a, b, n);
+    }
+    // chunks are numbered from the most significant one and handed out in that order, those below a
+    // chunk w/ a difference cannot change the result and are skipped
+    const std::size_t chunk = parallel::chunk_limbs, chunks = (n + chunk - 1) / chunk;
+    std::atomic<std::size_t> first { chunks };
+    std::vector<int> results(chunks);
+    parallel::for_each(chunks, [&](std::size_t i) {
+        if (i > first.load(std::memory_order_relaxed)) {
+            return;
+        }
+        const std::size_t end = n - i * chunk, begin = end > chunk ? end - chunk : 0;
+        results[i] = cmp_serial(a + begin, b + begin, end - begin);
+        if (results[i]) {
+            std::size_t current = first.load();
+            while (i < current && !first.compare_exchange_weak(current, i)) {}
+        }
+    });
+    return first < chunks ? results[first] : 0;
+}
+
+std::uint64_t arith::lshift(std::uint64_t* r, const std::uint64_t* a, std::size_t n, unsigned int bits) {
+    if (!bits) {
+        std::copy_backward(a, a + n, r + n);
+        return 0;
+    }
+    // most significant limb first, so that `r` may lie above `a`
+    const std::uint64_t out = n ? a[n - 1] >> (64 - bits) : 0;
+    for (std::size_t i = n; i-- > 1; ) {
+        r[i] = (a[i] << bits) | (a[i - 1] >> (64 - bits));
+    }
+    if (n) {
+        r[0] = a[0] << bits;
+    }
+    return out;
+}
+
+std::uint64_t arith::rshift(std::uint64_t* r, const std::uint64_t* a, std::size_t n, unsigned int bits) {
+    if (!bits) {
+        std::copy(a, a + n, r);
+        return 0;
+    }
+    // least significant limb first, so that `r` may lie below `a`
+    const std::uint64_t out = n ? a[0] << (64 - bits) : 0;
+    for (std::size_t i = 0; i + 1 < n; i++) {
+        r[i] = (a[i] >> bits) | (a[i + 1] << (64 - bits));
+    }
+    if (n) {
+        r[n - 1] = a[n - 1] >> bits;
+    }
+    return out;
+}
+
+/*--------------------*
+ *   Multiplication   *
+ *--------------------*/
+
+// Measured on x86-64 by timing balanced products of random operands: Karatsuba overtakes the
+// schoolbook method between 24 and 48 limbs, Toom-3 overtakes Karatsuba between 160 and 400
+// limbs and the NTT overtakes Toom-3 at about 8000 limbs (512k bits)
+arith::MulThresholds arith::mul_thresholds { 32, 250, 8000 };
+
+std::uint64_t arith::mul_1(std::uint64_t* r, const std::uint64_t* a, std::size_t n, std::uint64_t b) {
+    std::uint64_t carry = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        const uint128 p = static_cast<uint128>(a[i]) * b + carry;
+        r[i] = static_cast<std::uint64_t>(p);
+        carry = static_cast<std::uint64_t>(p >> 64);
+    }
+    return carry;
+}
+
+/**
+ * Computes `r += a * b` for numbers `r` and `a` of `n` limbs
+ *
+ * @returns the carry limb
+ */
+static std::uint64_t addmul_1(std::uint64_t* r, const std::uint64_t* a, std::size_t n, std::uint64_t b) {
+    std::uint64_t carry = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        const uint128 p = static_cast<uint128>(a[i]) * b + r[i] + carry;
+        r[i] = static_cast<std::uint64_t>(p);
+        carry = static_cast<std::uint64_t>(p >> 64);
+    }
+    return carry;
+}
+
+/**
+ * Adds `x` to the number `r` of `rn` limbs at a limb offset of `offset`
+ *
+ * `x` must fit into the `rn - offset` limbs above `offset`.
+ */
+static void add_at(std::uint64_t* r, std::size_t rn, const Limbs& x, std::size_t offset) {
+    if (!x.empty()) {
+        arith::add(r + offset, r + offset, rn - offset, x.data(), x.size());
+    }
+}
+
+/**
+ * Strips the leading zero limbs of `x`
+ */
+static Limbs& nat_trim(Limbs& x) {
+    while (!x.empty() && !x.back()) {
+        x.pop_back();
+    }
+    return x;
+}
+
+static Limbs nat_from(const std::uint64_t* a, std::size_t n) {
+    Limbs x(a, a + n);
+    return nat_trim(x);
+}
+
+static int nat_cmp(const Limbs& a, const Limbs& b) {
+    if (a.size() != b.size()) {
+        return a.size() < b.size() ? -1 : 1;
+    }
+    return arith::cmp_n(a.data(), b.data(), a.size());
+}
+
+static Limbs nat_add(const Limbs& a, const Limbs& b) {
+    const Limbs& longer = a.size() >= b.size() ? a : b;
+    const Limbs& shorter = a.size() >= b.size() ? b : a;
+    Limbs r(longer.size() + 1);
+    r[longer.size()] = arith::add(r.data(), longer.data(), longer.size(), shorter.data(), shorter.size());
+    return nat_trim(r);
+}
+
+/**
+ * @returns `a - b`, where `a` must not be less than `b`
+ */
+static Limbs nat_sub(const Limbs& a, const Limbs& b) {
+    Limbs r(a.size());
+    arith::sub(r.data(), a.data(), a.size(), b.data(), b.size());
+    return nat_trim(r);
+}
+
+/**
+ * @returns `a * 2^bits` for `bits < 64`
+ */
+static Limbs nat_shl(const Limbs& a, unsigned bits) {
+    Limbs r(a.size() + 1, 0);
+    for (std::size_t i = 0; i < a.size(); i++) {
+        r[i] |= a[i] << bits;
+        r[i + 1] = bits ? a[i] >> (64 - bits) : 0;
+    }
+    return nat_trim(r);
+}
+
+/**
+ * Divides `a` by 2 in place
+ */
+static void nat_half(Limbs& a) {
+    for (std::size_t i = 0; i < a.size(); i++) {
+        a[i] = (a[i] >> 1) | (i + 1 < a.size() ? a[i + 1] << 63 : 0);
+    }
+    nat_trim(a);
+}
+
+/**
+ * Divides `a`, which must be a multiple of 3, by 3 in place
+ */
+static void nat_divexact_3(Limbs& a) {
+    std::uint64_t rem = 0;
+    for (std::size_t i = a.size(); i-- > 0; ) {
+        const uint128 cur = (static_cast<uint128>(rem) << 64) | a[i];
+        a[i] = static_cast<std::uint64_t>(cur / 3);
+        rem = static_cast<std::uint64_t>(cur % 3);
+    }
+    nat_trim(a);
+}
+
+static Limbs nat_mul(const Limbs& a, const Limbs& b) {
+    if (a.empty() || b.empty()) {
+        return {};
+    }
+    Limbs r(a.size() + b.size());
+    if (&a == &b) {
+        arith::sqr(r.data(), a.data(), a.size());
+    } else {
+        arith::mul(r.data(), a.data(), a.size(), b.data(), b.size());
+    }
+    return nat_trim(r);
+}
+
+static void mul_basecase(std::uint64_t* r, const std::uint64_t* a, std::size_t an, const std::uint64_t* b, std::size_t bn) {
+    r[an] = arith::mul_1(r, a, an, b[0]);
+    for (std::size_t j = 1; j < bn; j++) {
+        r[an + j] = addmul_1(r + j, a, an, b[j]);
+    }
+}
+
+static void sqr_basecase(std::uint64_t* r, const std::uint64_t* a, std::size_t n) {
+    // every product a[i] * a[j] w/ i != j occurs twice, so it is computed once and doubled
+    std::fill(r, r + 2 * n, 0);
+    for (std::size_t i = 0; i < n; i++) {
+        r[i + n] = addmul_1(r + 2 * i + 1, a + i + 1, n - i - 1, a[i]);
+    }
+    for (std::size_t i = 2 * n; i-- > 1; ) {
+        r[i] = (r[i] << 1) | (r[i - 1] >> 63);
+    }
+    r[0] <<= 1;
+
+    std::uint64_t carry = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        const uint128 p = static_cast<uint128>(a[i]) * a[i];
+        const uint128 lo = static_cast<uint128>(r[2 * i]) + static_cast<std::uint64_t>(p) + carry;
+        r[2 * i] = static_cast<std::uint64_t>(lo);
+        const uint128 hi = static_cast<uint128>(r[2 * i + 1]) + static_cast<std::uint64_t>(p >> 64) + static_cast<std::uint64_t>(lo >> 64);
+        r[2 * i + 1] = static_cast<std::uint64_t>(hi);
+        carry = static_cast<std::uint64_t>(hi >> 64);
+    }
+}
+
+/**
+ * Runs the independent tasks of a multiplication of operands of `n` limbs, across the pool if the
+ * operands reach `parallel::mul_threshold`
+ *
+ * Every task has to write to its own results only, so the product does not depend on the order in
+ * which the tasks run.
+ */
+static void spread(std::size_t tasks, std::size_t n, const std::function<void(std::size_t)>& task) {
+    if (n >= parallel::mul_threshold) {
+        parallel::for_each(tasks, task);
+    } else {
+        for (std::size_t i = 0; i < tasks; i++) {
+            task(i);
+        }
+    }
+}
+
+static void mul_balanced(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n);
+
+static void sqr_n(std::uint64_t* r, const std::uint64_t* a, std::size_t n);
+
+/**
+ * Karatsuba: a * b = z2 * B^2m + (z1 - z2 - z0) * B^m + z0 w/ z1 = (a0 + a1)(b0 + b1)
+ *
+ * `a` and `b` may be the same array, in which case `z1` is computed by squaring.
+ */
+static void mul_karatsuba(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n) {
+    const std::size_t m = n - n / 2;
+    const std::size_t h = n / 2;
+    const bool square = a == b;
+
+    Limbs sa(m + 1), sb(m + 1), z1(2 * m + 2);
+    sa[m] = arith::add(sa.data(), a, m, a + m, h);
+    if (!square) {
+        sb[m] = arith::add(sb.data(), b, m, b + m, h);
+    }
+
+    // z0 and z2 are written to the lower and upper half of `r` directly
+    spread(3, n, [&](std::size_t i) {
+        if (i == 0) {
+            square ? sqr_n(r, a, m) : mul_balanced(r, a, b, m);
+        } else if (i == 1) {
+            square ? sqr_n(r + 2 * m, a + m, h) : mul_balanced(r + 2 * m, a + m, b + m, h);
+        } else {
+            square ? sqr_n(z1.data(), sa.data(), m + 1) : mul_balanced(z1.data(), sa.data(), sb.data(), m + 1);
+        }
+    });
+    arith::sub(z1.data(), z1.data(), z1.size(), r, 2 * m);
+    arith::sub(z1.data(), z1.data(), z1.size(), r + 2 * m, 2 * h);
+
+    // the middle term fits into the limbs above `m`, any excess limbs of `z1` are zero
+    arith::add(r + m, r + m, 2 * n - m, z1.data(), std::min(z1.size(), 2 * n - m));
+}
+
+/**
+ * Toom-Cook 3: the operands are split into three parts, treated as polynomials and evaluated at
+ * 0, 1, -1, 2 and infinity. The product polynomial is interpolated from the five point products.
+ */
+static void mul_toom3(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n) {
+    const std::size_t k = (n + 2) / 3;
+    const bool square = a == b;
+
+    const Limbs a0 = nat_from(a, k), a1 = nat_from(a + k, k), a2 = nat_from(a + 2 * k, n - 2 * k);
+    const Limbs b0 = nat_from(b, k), b1 = nat_from(b + k, k), b2 = nat_from(b + 2 * k, n - 2 * k);
+
+    // evaluation, where the value at -1 is kept as magnitude and sign
+    const Limbs a02 = nat_add(a0, a2), b02 = nat_add(b0, b2);
+    const Limbs pa1 = nat_add(a02, a1), pb1 = nat_add(b02, b1);
+    const bool pa_neg = nat_cmp(a02, a1) < 0, pb_neg = nat_cmp(b02, b1) < 0;
+    const Limbs pam1 = pa_neg ? nat_sub(a1, a02) : nat_sub(a02, a1);
+    const Limbs pbm1 = pb_neg ? nat_sub(b1, b02) : nat_sub(b02, b1);
+    const Limbs pa2 = nat_add(nat_add(a0, nat_shl(a1, 1)), nat_shl(a2, 2));
+    const Limbs pb2 = nat_add(nat_add(b0, nat_shl(b1, 1)), nat_shl(b2, 2));
+
+    const Limbs* const points[5][2] = {
+        { &a0, &b0 }, { &pa1, &pb1 }, { &pam1, &pbm1 }, { &pa2, &pb2 }, { &a2, &b2 },
+    };
+    Limbs products[5];
+    spread(5, n, [&](std::size_t i) {
+        products[i] = nat_mul(*points[i][0], square ? *points[i][0] : *points[i][1]);
+    });
+    const Limbs& r0 = products[0];
+    const Limbs& r1 = products[1];
+    const Limbs& rm1 = products[2];
+    const Limbs& r2 = products[3];
+    const Limbs& rinf = products[4];
+    const bool rm1_neg = !square && pa_neg != pb_neg;
+
+    // interpolation: every intermediate value is a non-negative combination of coefficients
+    Limbs even = rm1_neg ? nat_sub(r1, rm1) : nat_add(r1, rm1);     // 2 (c0 + c2 + c4)
+    Limbs odd = rm1_neg ? nat_add(r1, rm1) : nat_sub(r1, rm1);      // 2 (c1 + c3)
+    nat_half(even);
+    nat_half(odd);
+    const Limbs c2 = nat_sub(nat_sub(even, r0), rinf);
+    Limbs u = nat_sub(nat_sub(nat_sub(r2, r0), nat_shl(c2, 2)), nat_shl(rinf, 4)); // 2 c1 + 8 c3
+    nat_half(u);
+    Limbs c3 = nat_sub(u, odd);
+    nat_divexact_3(c3);
+    const Limbs c1 = nat_sub(odd, c3);
+
+    // recomposition
+    std::fill(r, r + 2 * n, 0);
+    add_at(r, 2 * n, r0, 0);
+    add_at(r, 2 * n, c1, k);
+    add_at(r, 2 * n, c2, 2 * k);
+    add_at(r, 2 * n, c3, 3 * k);
+    add_at(r, 2 * n, rinf, 4 * k);
+}
+
+/** The NTT prime p = 2^64 - 2^32 + 1, which has roots of unity of every order 2^k up to 2^32 */
+static constexpr std::uint64_t NTT_P = 0xffffffff00000001ULL;
+
+/** A generator of the multiplicative group modulo `NTT_P` */
+static constexpr std::uint64_t NTT_G = 7;
+
+// the modular operations are branch free, as the branches would be taken at random in a transform
+
+static std::uint64_t mod_add(std::uint64_t a, std::uint64_t b) {
+    // on overflow subtracting p modulo 2^64 yields the correct residue as well
+    const std::uint64_t s = a + b;
+    const std::uint64_t mask = 0 - static_cast<std::uint64_t>((s < a) | (s >= NTT_P));
+    return s - (NTT_P & mask);
+}
+
+static std::uint64_t mod_sub(std::uint64_t a, std::uint64_t b) {
+    const std::uint64_t mask = 0 - static_cast<std::uint64_t>(a < b);
+    return a - b + (NTT_P & mask);
+}
+
+static std::uint64_t mod_mul(std::uint64_t a, std::uint64_t b) {
+    // 2^64 = 2^32 - 1 and 2^96 = -1 (mod p)
+    const uint128 x = static_cast<uint128>(a) * b;
+    const std::uint64_t lo = static_cast<std::uint64_t>(x);
+    const std::uint64_t hi = static_cast<std::uint64_t>(x >> 64);
+    const std::uint64_t hi_hi = hi >> 32;
+    const std::uint64_t hi_lo = hi & 0xffffffffULL;
+
+    std::uint64_t t0 = lo - hi_hi;
+    t0 -= 0xffffffffULL & (0 - static_cast<std::uint64_t>(lo < hi_hi));
+    const std::uint64_t t1 = hi_lo * 0xffffffffULL;
+    std::uint64_t t2 = t0 + t1;
+    t2 += 0xffffffffULL & (0 - static_cast<std::uint64_t>(t2 < t1));
+    return t2 - (NTT_P & (0 - static_cast<std::uint64_t>(t2 >= NTT_P)));
+}
+
+static std::uint64_t mod_pow(std::uint64_t a, std::uint64_t e) {
+    std::uint64_t r = 1;
+    for (; e; e >>= 1) {
+        if (e & 1) {
+            r = mod_mul(r, a);
+        }
+        a = mod_mul(a, a);
+    }
+    return r;
+}
+
+/** The number of elements a task of a transform processes */
+static constexpr std::size_t NTT_CHUNK = std::size_t { 1 } << 12;
+
+/**
+ * Calls `task(begin, end)` for consecutive ranges covering `[0, n)`, which are spread across the
+ * pool in chunks of `NTT_CHUNK` elements if the pool is available
+ */
+static void ntt_ranges(std::size_t n, const std::function<void(std::size_t, std::size_t)>& task) {
+    if (n <= NTT_CHUNK || !parallel::available()) {
+        task(0, n);
+        return;
+    }
+    parallel::for_each((n + NTT_CHUNK - 1) / NTT_CHUNK, [&](std::size_t c) {
+        task(c * NTT_CHUNK, std::min(n, (c + 1) * NTT_CHUNK));
+    });
+}
+
+/**
+ * Transforms `x` (whose size is a power of 2) in place by an iterative Cooley-Tukey NTT
+ *
+ * The butterflies of a stage are independent, they are numbered `t = block * half + j` and split
+ * into ranges. Every range of twiddles starts at its own power of the root, so the results are
+ * the same however the stages are split.
+ */
+static void ntt(std::vector<std::uint64_t>& x, bool inverse) {
+    const std::size_t n = x.size();
+    for (std::size_t i = 1, j = 0; i < n; i++) {
+        std::size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            std::swap(x[i], x[j]);
+        }
+    }
+
+    std::vector<std::uint64_t> twiddles(n / 2);
+    for (std::size_t len = 2; len <= n; len <<= 1) {
+        const std::size_t half = len / 2;
+        const std::uint64_t root = mod_pow(NTT_G, (NTT_P - 1) / len);
+        const std::uint64_t w = inverse ? mod_pow(root, NTT_P - 2) : root;
+        ntt_ranges(half, [&](std::size_t begin, std::size_t end) {
+            std::uint64_t t = mod_pow(w, begin);
+            for (std::size_t j = begin; j < end; j++) {
+                twiddles[j] = t;
+                t = mod_mul(t, w);
+            }
+        });
+        ntt_ranges(n / 2, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t t = begin; t < end; ) {
+                // the butterflies of one block up to the end of the block or range
+                const std::size_t j0 = t & (half - 1);
+                const std::size_t i = 2 * (t - j0);
+                const std::size_t stop = std::min(half, j0 + (end - t));
+                for (std::size_t j = j0; j < stop; j++) {
+                    const std::uint64_t u = x[i + j];
+                    const std::uint64_t v = mod_mul(x[i + j + half], twiddles[j]);
+                    x[i + j] = mod_add(u, v);
+                    x[i + j + half] = mod_sub(u, v);
+                }
+                t += stop - j0;
+            }
+        });
+    }
+
+    if (inverse) {
+        const std::uint64_t n_inv = mod_pow(n % NTT_P, NTT_P - 2);
+        ntt_ranges(n, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; i++) {
+                x[i] = mod_mul(x[i], n_inv);
+            }
+        });
+    }
+}
+
+/**
+ * Multiplies by convolution of `w` bit digits in the NTT domain
+ *
+ * The digit width is chosen as large as possible such that the coefficients of the product,
+ * which are less than `n * 2^2w` for a transform of length `n`, are still exact modulo p.
+ * `a` and `b` may be the same array, in which case only one forward transform is done.
+ */
+static void mul_ntt(std::uint64_t* r, const std::uint64_t* a, std::size_t an, const std::uint64_t* b, std::size_t bn) {
+    unsigned w = 24;
+    std::size_t digits_a, digits_b, n;
+    for (;; w--) {
+        digits_a = (64 * an + w - 1) / w;
+        digits_b = (64 * bn + w - 1) / w;
+        unsigned log_n = 0;
+        for (n = 1; n < digits_a + digits_b; n <<= 1) {
+            log_n++;
+        }
+        if (2 * w + log_n <= 63) {
+            break;
+        }
+    }
+    const std::uint64_t mask = (std::uint64_t { 1 } << w) - 1;
+
+    const auto split = [n, w, mask](const std::uint64_t* x, std::size_t xn, std::size_t digits) {
+        std::vector<std::uint64_t> d(n, 0);
+        for (std::size_t i = 0; i < digits; i++) {
+            const std::size_t bit = i * w;
+            const std::size_t limb = bit / 64, shift = bit % 64;
+            std::uint64_t v = x[limb] >> shift;
+            if (shift + w > 64 && limb + 1 < xn) {
+                v |= x[limb + 1] << (64 - shift);
+            }
+            d[i] = v & mask;
+        }
+        return d;
+    };
+
+    std::vector<std::uint64_t> fa = split(a, an, digits_a);
+    ntt(fa, false);
+    const bool square = a == b && an == bn;
+    std::vector<std::uint64_t> fb;
+    if (!square) {
+        fb = split(b, bn, digits_b);
+        ntt(fb, false);
+    }
+    const std::vector<std::uint64_t>& other = square ? fa : fb;
+    ntt_ranges(n, [&](std::size_t begin, std::size_t end) {
+        for (std::size_t i = begin; i < end; i++) {
+            fa[i] = mod_mul(fa[i], other[i]);
+        }
+    });
+    ntt(fa, true);
+
+    std::fill(r, r + an + bn, 0);
+    uint128 carry = 0;
+    for (std::size_t i = 0; i < digits_a + digits_b && i * w < 64 * (an + bn); i++) {
+        carry += fa[i];
+        const std::uint64_t digit = static_cast<std::uint64_t>(carry) & mask;
+        carry >>= w;
+        const std::size_t bit = i * w;
+        const std::size_t limb = bit / 64, shift = bit % 64;
+        r[limb] |= digit << shift;
+        if (shift + w > 64 && limb + 1 < an + bn) {
+            r[limb + 1] |= digit >> (64 - shift);
+        }
+    }
+}
+
+static void mul_balanced(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n) {
+    const arith::MulThresholds& t = arith::mul_thresholds;
+    if (n < std::max<std::size_t>(t.karatsuba, 4)) {
+        mul_basecase(r, a, n, b, n);
+    } else if (n < std::max<std::size_t>(t.toom3, 6)) {
+        mul_karatsuba(r, a, b, n);
+    } else if (n < t.ntt) {
+        mul_toom3(r, a, b, n);
+    } else {
+        mul_ntt(r, a, n, b, n);
+    }
+}
+
+static void sqr_n(std::uint64_t* r, const std::uint64_t* a, std::size_t n) {
+    const arith::MulThresholds& t = arith::mul_thresholds;
+    if (n < std::max<std::size_t>(t.karatsuba, 4)) {
+        sqr_basecase(r, a, n);
+    } else if (n < std::max<std::size_t>(t.toom3, 6)) {
+        mul_karatsuba(r, a, a, n);
+    } else if (n < t.ntt) {
+        mul_toom3(r, a, a, n);
+    } else {
+        mul_ntt(r, a, n, a, n);
+    }
+}
+
+void arith::mul(std::uint64_t* r, const std::uint64_t* a, std::size_t an, const std::uint64_t* b, std::size_t bn) {
+    if (an < bn) {
+        std::swap(a, b);
+        std::swap(an, bn);
+    }
+
+    if (bn == 0) {
+        std::fill(r, r + an, 0);
+    } else if (bn < mul_thresholds.karatsuba) {
+        mul_basecase(r, a, an, b, bn);
+    } else if (an == bn) {
+        mul_balanced(r, a, b, bn);
+    } else if (bn >= mul_thresholds.ntt) {
+        mul_ntt(r, a, an, b, bn);
+    } else {
+        // unbalanced operands: `a` is multiplied by `b` in slices of `bn` limbs
+        std::fill(r, r + an + bn, 0);
+        const std::size_t slices = (an + bn - 1) / bn;
+        if (bn >= parallel::mul_threshold && parallel::available()) {
+            // one slice per thread is multiplied concurrently, the products are added in order
+            std::vector<Limbs> products(std::min(slices, parallel::threads()));
+            for (std::size_t first = 0; first < slices; first += products.size()) {
+                const std::size_t count = std::min(products.size(), slices - first);
+                parallel::for_each(count, [&](std::size_t i) {
+                    const std::size_t offset = (first + i) * bn;
+                    products[i].resize(std::min(bn, an - offset) + bn);
+                    mul(products[i].data(), a + offset, products[i].size() - bn, b, bn);
+                });
+                for (std::size_t i = 0; i < count; i++) {
+                    const std::size_t offset = (first + i) * bn;
+                    arith::add(r + offset, r + offset, an + bn - offset, products[i].data(), products[i].size());
+                }
+            }
+        } else {
+            Limbs t(2 * bn);
+            for (std::size_t offset = 0; offset < an; offset += bn) {
+                const std::size_t len = std::min(bn, an - offset);
+                mul(t.data(), a + offset, len, b, bn);
+                arith::add(r + offset, r + offset, an + bn - offset, t.data(), len + bn);
+            }
+        }
+    }
+}
+
+void arith::sqr(std::uint64_t* r, const std::uint64_t* a, std::size_t n) {
+    if (n) {
+        sqr_n(r, a, n);
+    }
+}
+
+/*--------------------*
+ *      Division      *
+ *--------------------*/
+
+// Measured on x86-64 by timing divisions of 2n by n limbs: Knuth's algorithm D stays ahead
+// up to about 6000 limbs, the Newton reciprocal only wins beyond that
+std::size_t arith::div_threshold = 6000;
+
+/**
+ * Computes `r -= a * b` for numbers `r` and `a` of `n` limbs
+ *
+ * @returns the borrow limb
+ */
+static std::uint64_t submul_1(std::uint64_t* r, const std::uint64_t* a, std::size_t n, std::uint64_t b) {
+    std::uint64_t borrow = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        const uint128 p = static_cast<uint128>(a[i]) * b + borrow;
+        const std::uint64_t lo = static_cast<std::uint64_t>(p);
+        borrow = static_cast<std::uint64_t>(p >> 64) + (r[i] < lo);
+        r[i] -= lo;
+    }
+    return borrow;
+}
+
+std::uint64_t arith::divrem_1(std::uint64_t* q, const std::uint64_t* a, std::size_t n, std::uint64_t d) {
+    std::uint64_t rem = 0;
+    for (std::size_t i = n; i-- > 0; ) {
+        const uint128 cur = (static_cast<uint128>(rem) << 64) | a[i];
+        q[i] = static_cast<std::uint64_t>(cur / d);
+        rem = static_cast<std::uint64_t>(cur % d);
+    }
+    return rem;
+}
+
+/**
+ * Knuth's algorithm D (TAOCP 4.3.1)
+ *
+ * Divides `u` of `un` limbs by a normalized (most significant bit set) divisor `v` of `vn >= 2`
+ * limbs, where the upper `vn` limbs of `u` must be less than `v`. The `un - vn` quotient limbs are
+ * written to `q`, the remainder replaces the lower `vn` limbs of `u`.
+ */
+static void divrem_knuth(std::uint64_t* q, std::uint64_t* u, std::size_t un, const std::uint64_t* v, std::size_t vn) {
+    const std::uint64_t v1 = v[vn - 1], v2 = v[vn - 2];
+    for (std::size_t j = un - vn; j-- > 0; ) {
+        // estimate the quotient limb from the top limbs, it is at most one too large afterwards
+        const uint128 num = (static_cast<uint128>(u[j + vn]) << 64) | u[j + vn - 1];
+        uint128 qhat = num / v1;
+        uint128 rhat = num % v1;
+        while ((qhat >> 64) || qhat * v2 > ((rhat << 64) | u[j + vn - 2])) {
+            qhat--;
+            rhat += v1;
+            if (rhat >> 64) {
+                break;
+            }
+        }
+
+        const std::uint64_t borrow = submul_1(u + j, v, vn, static_cast<std::uint64_t>(qhat));
+        const bool negative = u[j + vn] < borrow;
+        u[j + vn] -= borrow;
+        if (negative) {
+            qhat--;
+            u[j + vn] += arith::add_n(u + j, u + j, v, vn);
+        }
+        q[j] = static_cast<std::uint64_t>(qhat);
+    }
+}
+
+/**
+ * Computes the reciprocal `floor((B^2n - 1) / d)` of a normalized divisor `d` of `n` limbs
+ *
+ * The reciprocal of the upper half of `d` is refined by one Newton step, which doubles its
+ * precision. The result is then corrected to the exact value, which takes a few steps at most.
+ *
+ * @returns the reciprocal (`n + 1` limbs at most, its most significant limb is 1 at most)
+ */
+static Limbs reciprocal(const std::uint64_t* d, std::size_t n) {
+    const Limbs divisor = nat_from(d, n);
+    const Limbs ones(2 * n, ~std::uint64_t { 0 });
+
+    if (n < std::max<std::size_t>(arith::div_threshold, 4)) {
+        Limbs u(ones), q(n + 1);
+        u.push_back(0);
+        divrem_knuth(q.data(), u.data(), u.size(), d, n);
+        return nat_trim(q);
+    }
+
+    const std::size_t h = (n + 1) / 2;
+    const Limbs half = reciprocal(d + (n - h), h);
+    Limbs x(n - h, 0);
+    x.insert(x.end(), half.begin(), half.end());
+
+    // Newton step x' = x + x (B^2n - d x) / B^2n, w/ the error term kept as magnitude and sign
+    Limbs power(2 * n + 1, 0);
+    power[2 * n] = 1;
+    const Limbs dx = nat_mul(divisor, x);
+    const bool negative = nat_cmp(dx, power) > 0;
+    const Limbs error = negative ? nat_sub(dx, power) : nat_sub(power, dx);
+    Limbs correction = nat_mul(x, error);
+    correction.erase(correction.begin(), correction.begin() + static_cast<long>(std::min(correction.size(), 2 * n)));
+    nat_trim(correction);
+    x = negative ? nat_sub(x, nat_add(correction, Limbs { 1 })) : nat_add(x, correction);
+
+    // exact correction, such that 0 <= B^2n - 1 - d x < d
+    Limbs product = nat_mul(divisor, x);
+    while (nat_cmp(product, ones) > 0) {
+        x = nat_sub(x, Limbs { 1 });
+        product = nat_sub(product, divisor);
+    }
+    Limbs rem = nat_sub(ones, product);
+    while (nat_cmp(rem, divisor) >= 0) {
+        x = nat_add(x, Limbs { 1 });
+        rem = nat_sub(rem, divisor);
+    }
+    return x;
+}
+
+/**
+ * Division by multiplication w/ the reciprocal of `v`
+ *
+ * Same contract as `divrem_knuth`. The quotient is computed from the top in blocks of `vn` limbs
+ * (long division in base B^vn), where every block is estimated by a multiplication w/ the
+ * reciprocal, which is at most 2 too small, and corrected afterwards.
+ */
+static void divrem_newton(std::uint64_t* q, std::uint64_t* u, std::size_t un, const std::uint64_t* v, std::size_t vn) {
+    const Limbs divisor = nat_from(v, vn);
+    const Limbs inverse = reciprocal(v, vn);
+
+    for (std::size_t pos = un - vn; pos > 0; ) {
+        const std::size_t k = std::min(vn, pos);
+        const std::size_t j = pos - k;
+
+        // cur = u[j, j + vn + k) < v * B^k
+        Limbs cur = nat_from(u + j, vn + k);
+        Limbs block = nat_mul(cur, inverse);
+        block.erase(block.begin(), block.begin() + static_cast<long>(std::min(block.size(), 2 * vn)));
+        nat_trim(block);
+        cur = nat_sub(cur, nat_mul(block, divisor));
+        while (nat_cmp(cur, divisor) >= 0) {
+            cur = nat_sub(cur, divisor);
+            block = nat_add(block, Limbs { 1 });
+        }
+
+        std::fill(q + j, q + j + k, 0);
+        std::copy(block.begin(), block.end(), q + j);
+        std::fill(u + j, u + j + vn + k, 0);
+        std::copy(cur.begin(), cur.end(), u + j);
+        pos = j;
+    }
+}
+
+void arith::divrem(std::uint64_t* q, std::uint64_t* r, const std::uint64_t* a, std::size_t an, const std::uint64_t* d, std::size_t dn) {
+    if (dn == 1) {
+        r[0] = arith::divrem_1(q, a, an, d[0]);
+        return;
+    }
+
+    // normalize the divisor, such that its most significant bit is set
+    const unsigned bits = static_cast<unsigned>(__builtin_clzll(d[dn - 1]));
+    Limbs v(dn), u(an + 1);
+    arith::lshift(v.data(), d, dn, bits);
+    u[an] = arith::lshift(u.data(), a, an, bits);
+
+    if (dn >= div_threshold && an + 1 - dn >= div_threshold) {
+        divrem_newton(q, u.data(), u.size(), v.data(), dn);
+    } else {
+        divrem_knuth(q, u.data(), u.size(), v.data(), dn);
+    }
+    arith::rshift(r, u.data(), dn, bits);
+}
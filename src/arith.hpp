@@ -0,0 +1,152 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Multi-precision arithmetic on raw limb arrays (least significant limb first)
+ *
+ * The functions neither allocate nor normalize, callers are responsible for providing
+ * result arrays of sufficient size.
+ */
+namespace arith {
+
+    /**
+     * Adds two numbers of `n` limbs each
+     *
+     * `r` may alias `a` or `b`.
+     *
+     * @param r the array of `n` limbs receiving `a + b` (w/o the final carry)
+     * @returns the carry out of the most significant limb (`0` or `1`)
+     */
+    std::uint64_t add_n(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n);
+
+    /**
+     * Adds a number of `bn` limbs to a number of `an >= bn` limbs
+     *
+     * `r` may alias `a` or `b`.
+     *
+     * @param r the array of `an` limbs receiving `a + b` (w/o the final carry)
+     * @returns the carry out of the most significant limb (`0` or `1`)
+     */
+    std::uint64_t add(std::uint64_t* r, const std::uint64_t* a, std::size_t an, const std::uint64_t* b, std::size_t bn);
+
+    /**
+     * Subtracts two numbers of `n` limbs each
+     *
+     * `r` may alias `a` or `b`.
+     *
+     * @param r the array of `n` limbs receiving `a - b` (modulo 2^(64n))
+     * @returns the borrow out of the most significant limb (`0` or `1`)
+     */
+    std::uint64_t sub_n(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n);
+
+    /**
+     * Subtracts a number of `bn` limbs from a number of `an >= bn` limbs
+     *
+     * `r` may alias `a` or `b`.
+     *
+     * @param r the array of `an` limbs receiving `a - b` (modulo 2^(64an))
+     * @returns the borrow out of the most significant limb (`0` or `1`)
+     */
+    std::uint64_t sub(std::uint64_t* r, const std::uint64_t* a, std::size_t an, const std::uint64_t* b, std::size_t bn);
+
+    /**
+     * Compares two numbers of `n` limbs each, most significant limb first
+     *
+     * @returns 0 if `a` and `b` are equivalent, < 0, if `a` is less than `b`, > 0 otherwise
+     */
+    int cmp_n(const std::uint64_t* a, const std::uint64_t* b, std::size_t n);
+
+    /**
+     * Shifts a number of `n` limbs to the left by `bits < 64` bits
+     *
+     * `r` may alias `a` or overlap it at a higher address.
+     *
+     * @param r the array of `n` limbs receiving `a << bits` (w/o the bits shifted out)
+     * @returns the bits shifted out of the most significant limb (in the low bits)
+     */
+    std::uint64_t lshift(std::uint64_t* r, const std::uint64_t* a, std::size_t n, unsigned int bits);
+
+    /**
+     * Shifts a number of `n` limbs to the right by `bits < 64` bits
+     *
+     * `r` may alias `a` or overlap it at a lower address.
+     *
+     * @param r the array of `n` limbs receiving `a >> bits`
+     * @returns the bits shifted out of the least significant limb (in the high bits)
+     */
+    std::uint64_t rshift(std::uint64_t* r, const std::uint64_t* a, std::size_t n, unsigned int bits);
+
+    /**
+     * Multiplies a number of `n` limbs by a single limb
+     *
+     * `r` may alias `a`.
+     *
+     * @param r the array of `n` limbs receiving `a * b` (w/o the carry limb)
+     * @returns the carry limb
+     */
+    std::uint64_t mul_1(std::uint64_t* r, const std::uint64_t* a, std::size_t n, std::uint64_t b);
+
+    /**
+     * Operand sizes (in limbs) at which multiplication switches to the next algorithm
+     *
+     * Operands smaller than `karatsuba` are multiplied by the schoolbook method, operands of at
+     * least `karatsuba`, `toom3` or `ntt` limbs by Karatsuba, Toom-Cook 3 or a number-theoretic
+     * transform respectively. The defaults have been measured on x86-64 (see `arith.cpp`).
+     */
+    struct MulThresholds {
+        std::size_t karatsuba;
+        std::size_t toom3;
+        std::size_t ntt;
+    };
+
+    /**
+     * The thresholds used by `mul` and `sqr`, may be tuned at runtime
+     */
+    extern MulThresholds mul_thresholds;
+
+    /**
+     * Multiplies a number of `an` limbs by a number of `bn` limbs
+     *
+     * `r` must neither alias `a` nor `b`.
+     *
+     * @param r the array of `an + bn` limbs receiving `a * b`
+     */
+    void mul(std::uint64_t* r, const std::uint64_t* a, std::size_t an, const std::uint64_t* b, std::size_t bn);
+
+    /**
+     * Squares a number of `n` limbs
+     *
+     * `r` must not alias `a`.
+     *
+     * @param r the array of `2n` limbs receiving `a * a`
+     */
+    void sqr(std::uint64_t* r, const std::uint64_t* a, std::size_t n);
+
+    /**
+     * Divides a number of `n` limbs by a single limb `d != 0`
+     *
+     * `q` may alias `a`.
+     *
+     * @param q the array of `n` limbs receiving the quotient
+     * @returns the remainder
+     */
+    std::uint64_t divrem_1(std::uint64_t* q, const std::uint64_t* a, std::size_t n, std::uint64_t d);
+
+    /**
+     * Divisor and quotient size (in limbs) from which on division uses a Newton reciprocal
+     *
+     * Smaller divisions use Knuth's algorithm D, may be tuned at runtime.
+     */
+    extern std::size_t div_threshold;
+
+    /**
+     * Divides a number of `an` limbs by a number of `dn` limbs, where `an >= dn` and `d[dn - 1] != 0`
+     *
+     * Neither `q` nor `r` may alias `a` or `d`.
+     *
+     * @param q the array of `an - dn + 1` limbs receiving the quotient
+     * @param r the array of `dn` limbs receiving the remainder
+     */
+    void divrem(std::uint64_t* q, std::uint64_t* r, const std::uint64_t* a, std::size_t an, const std::uint64_t* d, std::size_t dn);
+}
@@ -2,63 +2,219 @@
 #include <sstream>
 #include <ostream>
 #include <tuple>
+#include <locale>
 #include <algorithm>
-#include "./functions.hpp"
+#include <cerrno>
+#include <unistd.h>
 #include "./binary.hpp"
+#include "./kernels.hpp"
+#include "./arith.hpp"
+#include "./archive.hpp"
+#include "./decimal.hpp"
+#include "./radix.hpp"
+
+/** The number of bits held by a single limb */
+static constexpr std::size_t LIMB_BITS = 64;
+
+/**
+ * @returns the number of limbs needed to hold `bits` bits
+ */
+static std::size_t limbs_for(std::size_t bits) {
+    return (bits + LIMB_BITS - 1) / LIMB_BITS;
+}
+
+/**
+ * @returns the number of significant bits of `l` (`0` if `l` equals zero)
+ */
+static std::size_t bit_width(std::uint64_t l) {
+    return l ? LIMB_BITS - static_cast<std::size_t>(__builtin_clzll(l)) : 0;
+}
 
-Binary::Binary() : m_bits {} {}
+Binary::Binary() : m_limbs {}, m_size { 0 }, m_parity { 0 }, m_hash { 0 } {}
 
-Binary::Binary(unsigned long long int l) : m_bits { }
+Binary::Binary(unsigned long long int l)
+    : m_limbs { l }
+    , m_size { std::max<std::size_t>(1, bit_width(l)) }
+    , m_parity { __builtin_popcountll(l) }
+    , m_hash { 0 }
+    {}
+
+Binary::Binary(const std::vector<bool>& bits) : m_limbs(limbs_for(bits.size())), m_size { bits.size() }, m_parity { -1 }, m_hash { 0 }
 {
-    if (l == 0) {
-        m_bits.push_back(false);
-    } else {
-        while (l) {
-            m_bits.insert(m_bits.begin(), l & 1);
-            l = l >> 1;
+    std::size_t i = bits.size();
+    for (const bool bit : bits) {
+        --i;
+        if (bit) {
+            m_limbs[i / LIMB_BITS] |= std::uint64_t { 1 } << (i % LIMB_BITS);
         }
     }
+    normalize();
 }
 
-Binary::Binary(const std::vector<bool>& bits) : m_bits { bits }
+Binary::Binary(const char* s, std::size_t n) : m_limbs(limbs_for(n)), m_size { n }, m_parity { -1 }, m_hash { 0 }
 {
-    while (m_bits.size() > 1 && !m_bits.front()) {
-        m_bits.erase(m_bits.begin());
+    const std::size_t invalid = kernels::parse_bits(m_limbs.data(), s, n);
+    if (invalid != n) {
+        throw std::invalid_argument("Binary string representation must only contain '0' or '1', found '"
+                                    + std::string(1, s[invalid]) + "' at position " + std::to_string(invalid));
+    }
+    normalize();
+}
+
+Binary Binary::from_dec(const char* s, std::size_t n) {
+    const std::size_t invalid = decimal::find_invalid(s, n);
+    if (invalid != n) {
+        throw std::invalid_argument("Decimal string representation must only contain '0' to '9', found '"
+                                    + std::string(1, s[invalid]) + "' at position " + std::to_string(invalid));
+    }
+    if (!n) {
+        return Binary();
     }
+    LimbVector limbs = decimal::parse(s, n);
+    const std::size_t size = 64 * limbs.size();
+    return Binary(std::move(limbs), size);
+}
+
+Binary Binary::from_hex(const char* s, std::size_t n) {
+    return from_radix(s, n, 4, "Hexadecimal", "'0' to '9' or 'a' to 'f'");
+}
+
+Binary Binary::from_oct(const char* s, std::size_t n) {
+    return from_radix(s, n, 3, "Octal", "'0' to '7'");
+}
+
+Binary Binary::from_radix(const char* s, std::size_t n, unsigned int bits, const char* name, const char* digits) {
+    LimbVector limbs(limbs_for(bits * n));
+    const std::size_t invalid = radix::parse(limbs.data(), s, n, bits);
+    if (invalid != n) {
+        throw std::invalid_argument(std::string(name) + " string representation must only contain " + digits
+                                    + ", found '" + std::string(1, s[invalid]) + "' at position " + std::to_string(invalid));
+    }
+    return Binary(std::move(limbs), bits * n);
+}
+
+Binary::Binary(LimbVector limbs, std::size_t size) : m_limbs { std::move(limbs) }, m_size { size }, m_parity { -1 }, m_hash { 0 }
+{
+    normalize();
 }
 
-Binary Binary::operator&(const Binary& rhs) const {
-    std::vector<bool> bits = this->combine(rhs, std::logical_and<bool>());
-    return { bits };
+Binary Binary::operator&(const Binary& rhs) const & {
+    // the result has no more limbs than the shorter operand, so that one is copied
+    const bool shorter = m_limbs.size() <= rhs.m_limbs.size();
+    Binary result(shorter ? *this : rhs);
+    result &= shorter ? rhs : *this;
+    return result;
+}
+
+Binary Binary::operator&(const Binary& rhs) && {
+    *this &= rhs;
+    return std::move(*this);
 }
 
 Binary& Binary::operator&=(const Binary& rhs) {
-    this->m_bits = this->combine(rhs, std::logical_and<bool>());
-    return *this;
+    return this->combine(rhs, kernels::and_n, false);
 }
 
-Binary Binary::operator|(const Binary& rhs) const {
-    std::vector<bool> bits = this->combine(rhs, std::logical_or<bool>());
-    return { bits };
+Binary Binary::operator|(const Binary& rhs) const & {
+    // the result has as many limbs as the longer operand, so that one is copied
+    const bool longer = m_limbs.size() >= rhs.m_limbs.size();
+    Binary result(longer ? *this : rhs);
+    result |= longer ? rhs : *this;
+    return result;
+}
+
+Binary Binary::operator|(const Binary& rhs) && {
+    *this |= rhs;
+    return std::move(*this);
 }
 
 Binary& Binary::operator|=(const Binary& rhs) {
-    this->m_bits = this->combine(rhs, std::logical_or<bool>());
-    return *this;
+    return this->combine(rhs, kernels::or_n, true);
 }
 
-Binary Binary::operator^(const Binary& rhs) const {
-    std::vector<bool> bits = this->combine(rhs, std::not_equal_to<bool>());
-    return { bits };
+Binary Binary::operator^(const Binary& rhs) const & {
+    const bool longer = m_limbs.size() >= rhs.m_limbs.size();
+    Binary result(longer ? *this : rhs);
+    result ^= longer ? rhs : *this;
+    return result;
+}
+
+Binary Binary::operator^(const Binary& rhs) && {
+    *this ^= rhs;
+    return std::move(*this);
 }
 
 Binary& Binary::operator^=(const Binary& rhs) {
-    this->m_bits = this->combine(rhs, std::not_equal_to<bool>());
+    return this->combine(rhs, kernels::xor_n, true);
+}
+
+Binary Binary::operator+(const Binary& rhs) const & {
+    // add into a fresh array that already has room for the final carry
+    const Binary& longer = m_limbs.size() >= rhs.m_limbs.size() ? *this : rhs;
+    const Binary& shorter = m_limbs.size() >= rhs.m_limbs.size() ? rhs : *this;
+    LimbVector limbs(longer.m_limbs.size() + 1);
+    limbs.back() = arith::add(limbs.data(), longer.m_limbs.data(), longer.m_limbs.size(), shorter.m_limbs.data(), shorter.m_limbs.size());
+    const std::size_t size = std::max(m_size, rhs.m_size) ? limbs.size() * LIMB_BITS : 0;
+    return { std::move(limbs), size };
+}
+
+Binary Binary::operator+(const Binary& rhs) && {
+    *this += rhs;
+    return std::move(*this);
+}
+
+Binary& Binary::operator+=(const Binary& rhs) {
+    const std::size_t size = std::max(m_size, rhs.m_size);
+    if (m_limbs.size() < rhs.m_limbs.size()) {
+        m_limbs.resize(rhs.m_limbs.size(), 0);
+    }
+    const std::uint64_t carry = arith::add(m_limbs.data(), m_limbs.data(), m_limbs.size(), rhs.m_limbs.data(), rhs.m_limbs.size());
+    if (carry) {
+        m_limbs.push_back(carry);
+    }
+    m_size = size ? m_limbs.size() * LIMB_BITS : 0;
+    normalize();
     return *this;
 }
 
-Binary Binary::operator-(const Binary& rhs) const {
-    return { this->to_l() - rhs.to_l() }; // FIXME: implement without using to_l()
+Binary Binary::operator-(const Binary& rhs) const & {
+    Binary result(*this);
+    result -= rhs;
+    return result;
+}
+
+Binary Binary::operator-(const Binary& rhs) && {
+    *this -= rhs;
+    return std::move(*this);
+}
+
+Binary& Binary::operator-=(const Binary& rhs) {
+    if (*this < rhs) {
+        throw std::domain_error("Subtraction result is negative");
+    }
+    // `this` >= `rhs` implies that `rhs` has no more (significant) limbs than `this`
+    arith::sub(m_limbs.data(), m_limbs.data(), m_limbs.size(), rhs.m_limbs.data(), std::min(m_limbs.size(), rhs.m_limbs.size()));
+    normalize();
+    return *this;
+}
+
+Binary Binary::operator*(const Binary& rhs) const {
+    if (!m_size && !rhs.m_size) {
+        return {};
+    }
+    LimbVector limbs(m_limbs.size() + rhs.m_limbs.size());
+    if (m_limbs == rhs.m_limbs) {
+        arith::sqr(limbs.data(), m_limbs.data(), m_limbs.size());
+    } else {
+        arith::mul(limbs.data(), m_limbs.data(), m_limbs.size(), rhs.m_limbs.data(), rhs.m_limbs.size());
+    }
+    const std::size_t size = limbs.size() * LIMB_BITS;
+    return { std::move(limbs), size };
+}
+
+Binary& Binary::operator*=(const Binary& rhs) {
+    *this = *this * rhs;
+    return *this;
 }
 
 Binary Binary::operator/(const Binary& divisor) const {
@@ -73,29 +229,81 @@ std::tuple<Binary,Binary> Binary::div(const Binary& other) const {
     } else if (other > *this) {
         return { { 0 }, other };
     } else {
-        std::vector<bool> dividend = this->m_bits;
-        std::vector<bool> divisor = other.m_bits;
-        std::vector<bool> quotient { };
-        std::vector<bool> rem { dividend.begin(), dividend.begin() + static_cast<long>(divisor.size()) };
-        auto it = dividend.begin() + static_cast<long>(divisor.size());
-        
-        do {
-            auto cmp = Binary(rem).compare(divisor);
-            if (!(cmp < 0)) {
-                rem = (Binary(rem) - Binary(divisor)).m_bits;
-                quotient.push_back(1);
-            } else {
-                quotient.push_back(0);
-            }
-            if (it == dividend.end()) {
-                break;
-            } else {
-                rem.push_back(*it); it++;
-            }
-        } while (true);
+        const std::size_t an = m_limbs.size(), dn = other.m_limbs.size();
+        LimbVector quotient(an - dn + 1), rem(dn);
+        arith::divrem(quotient.data(), rem.data(), m_limbs.data(), an, other.m_limbs.data(), dn);
+        return { Binary(std::move(quotient), m_size), Binary(std::move(rem), other.m_size) };
+    }
+}
+
+Binary Binary::operator<<(std::size_t n) const & {
+    if (m_size <= 1 && !limb(0)) {
+        return *this;
+    }
+    const std::size_t words = n / LIMB_BITS;
+    LimbVector limbs(m_limbs.size() + words + 1, 0);
+    limbs.back() = arith::lshift(limbs.data() + words, m_limbs.data(), m_limbs.size(), static_cast<unsigned int>(n % LIMB_BITS));
+    Binary result(std::move(limbs), m_size + n);
+    result.m_parity = m_parity;
+    return result;
+}
+
+Binary Binary::operator<<(std::size_t n) && {
+    *this <<= n;
+    return std::move(*this);
+}
+
+Binary& Binary::operator<<=(std::size_t n) {
+    if (m_size <= 1 && !limb(0)) {
+        return *this;
+    }
+    // move the limbs up in place, the vector's capacity grows geometrically for repeated shifts
+    const long parity = m_parity;
+    const std::size_t words = n / LIMB_BITS, count = m_limbs.size();
+    const unsigned int bits = static_cast<unsigned int>(n % LIMB_BITS);
+    // only grow by a carry limb if bits are actually shifted out of the most significant limb
+    const std::size_t carry = bits && m_limbs.back() >> (LIMB_BITS - bits) ? 1 : 0;
+    m_limbs.resize(count + words + carry, 0);
+    const std::uint64_t out = arith::lshift(m_limbs.data() + words, m_limbs.data(), count, bits);
+    if (carry) {
+        m_limbs.back() = out;
+    }
+    std::fill_n(m_limbs.begin(), words, 0);
+    m_size += n;
+    normalize();
+    m_parity = parity;
+    return *this;
+}
+
+Binary Binary::operator>>(std::size_t n) const & {
+    const std::size_t words = n / LIMB_BITS;
+    if (!n || !m_size) {
+        return *this;
+    } else if (words >= m_limbs.size()) {
+        return { 0 };
+    }
+    LimbVector limbs(m_limbs.size() - words);
+    arith::rshift(limbs.data(), m_limbs.data() + words, limbs.size(), static_cast<unsigned int>(n % LIMB_BITS));
+    return { std::move(limbs), m_size };
+}
 
-        return { quotient, rem };
+Binary Binary::operator>>(std::size_t n) && {
+    *this >>= n;
+    return std::move(*this);
+}
+
+Binary& Binary::operator>>=(std::size_t n) {
+    const std::size_t words = n / LIMB_BITS;
+    if (!n || !m_size) {
+        return *this;
+    } else if (words >= m_limbs.size()) {
+        m_limbs.assign(1, 0);
+    } else {
+        arith::rshift(m_limbs.data(), m_limbs.data() + words, m_limbs.size() - words, static_cast<unsigned int>(n % LIMB_BITS));
+        m_limbs.resize(m_limbs.size() - words);
     }
+    normalize();
+    return *this;
 }
 
 bool Binary::operator>(const Binary& rhs) const {
@@ -107,109 +315,313 @@ bool Binary::operator<(const Binary& rhs) const {
 }
 
 bool Binary::operator==(const Binary& rhs) const {
+    // differing cached properties prove inequality w/o touching the limbs
+    if ((m_parity >= 0 && rhs.m_parity >= 0 && m_parity != rhs.m_parity) || (m_hash && rhs.m_hash && m_hash != rhs.m_hash)) {
+        return false;
+    }
     return this->compare(rhs) == 0;
 }
 
 bool Binary::operator!=(const Binary& rhs) const {
-    return this->compare(rhs) != 0;
+    return !(*this == rhs);
 }
 
 std::ostream& operator<<(std::ostream& os, const Binary& bin) {
-    os << bin.to_str();
+    const std::ios::fmtflags base = os.flags() & std::ios::basefield;
+    auto sink = [](void* stream, const char* chars, std::size_t n) {
+        static_cast<std::ostream*>(stream)->write(chars, static_cast<std::streamsize>(n));
+    };
+    if (base == std::ios::hex || base == std::ios::oct) {
+        if ((os.flags() & std::ios::showbase) && !bin.m_limbs.empty()) {
+            os << (base == std::ios::hex ? "0x" : "0o");
+        }
+        radix::write(bin.m_limbs.data(), bin.m_limbs.size(), base == std::ios::hex ? 4 : 3, sink, &os);
+        return os;
+    }
+    bin.write_chunks(sink, &os);
     return os;
 }
 
 std::istream& operator>>(std::istream& is, Binary& bin) {
-    std::string s;
-    is >> s;
-    bin.emplace(s);
+    // the digits are parsed block by block as they are read from the stream buffer, w/o collecting
+    // the whole token in a string first
+    constexpr std::size_t BLOCK_LIMBS = 64, BLOCK_CHARS = BLOCK_LIMBS * LIMB_BITS;
+    using traits = std::istream::traits_type;
+    char block[BLOCK_CHARS];
+    std::uint64_t parsed[BLOCK_LIMBS];
+
+    // the limbs of all complete blocks, the most significant limb first
+    LimbVector high;
+    std::size_t count = 0, n = 0, invalid = std::string::npos;
+    char found = 0;
+    auto parse = [&]() {
+        const std::size_t at = kernels::parse_bits(parsed, block, n);
+        if (at != n && invalid == std::string::npos) {
+            invalid = count + at;
+            found = block[at];
+        }
+    };
+
+    std::ios::iostate state = std::ios::goodbit;
+    const std::istream::sentry sentry(is);
+    if (sentry) {
+        const std::ctype<char>& ctype = std::use_facet<std::ctype<char> >(is.getloc());
+        std::streambuf* buf = is.rdbuf();
+        for (;;) {
+            const traits::int_type c = buf->sgetc();
+            if (traits::eq_int_type(c, traits::eof())) {
+                state |= std::ios::eofbit;
+                break;
+            } else if (ctype.is(std::ctype_base::space, traits::to_char_type(c))) {
+                break;
+            }
+            block[n++] = traits::to_char_type(c);
+            buf->sbumpc();
+            if (n == BLOCK_CHARS) {
+                parse();
+                for (std::size_t i = BLOCK_LIMBS; i-- > 0; ) {
+                    high.push_back(parsed[i]);
+                }
+                count += n;
+                n = 0;
+            }
+        }
+    }
+    if (!count && !n) {
+        state |= std::ios::failbit;
+    }
+    if (n) {
+        parse();
+    }
+    if (state != std::ios::goodbit) {
+        is.setstate(state);
+    }
+    if (invalid != std::string::npos) {
+        throw std::invalid_argument("Binary string representation must only contain '0' or '1', found '"
+                                    + std::string(1, found) + "' at position " + std::to_string(invalid));
+    }
+
+    // the last, partial block makes up the low bits
+    LimbVector limbs(limbs_for(n));
+    std::copy(parsed, parsed + limbs.size(), limbs.begin());
+    Binary low(std::move(limbs), n);
+    if (count) {
+        std::reverse(high.begin(), high.end());
+        bin = (Binary(std::move(high), count) << n) | low;
+    } else {
+        bin = std::move(low);
+    }
     return is;
 }
 
-Binary Binary::concat(const Binary& other) const {
-    std::vector<bool> bits = this->m_bits;
-    std::copy(other.m_bits.begin(), other.m_bits.end(), std::back_inserter(bits));
-    return { bits };
+Binary Binary::concat(const Binary& other) const & {
+    if (!other.m_size) {
+        return *this;
+    } else if (m_size <= 1 && !limb(0)) {
+        return other;
+    }
+    // `this` is moved above `other`'s bits, which leaves room for `other` in the low limbs
+    Binary result = *this << other.m_size;
+    kernels::or_n(result.m_limbs.data(), result.m_limbs.data(), other.m_limbs.data(), other.m_limbs.size());
+    result.m_parity = m_parity >= 0 && other.m_parity >= 0 ? m_parity + other.m_parity : -1;
+    return result;
 }
 
-long Binary::parity() const {
-    return std::count_if(m_bits.begin(), m_bits.end(), identity<bool>);
+Binary Binary::concat(const Binary& other) && {
+    if (!other.m_size) {
+        return std::move(*this);
+    } else if (m_size <= 1 && !limb(0)) {
+        return other;
+    }
+    const long parity = m_parity >= 0 && other.m_parity >= 0 ? m_parity + other.m_parity : -1;
+    *this <<= other.m_size;
+    kernels::or_n(m_limbs.data(), m_limbs.data(), other.m_limbs.data(), other.m_limbs.size());
+    m_parity = parity;
+    return std::move(*this);
 }
 
-std::string Binary::to_str() const {
-    std::stringstream ss;
-    for (const bool bit : m_bits) {
-        ss << (bit ? "1" : "0");
+long Binary::parity() const {
+    if (m_parity < 0) {
+        m_parity = static_cast<long>(kernels::popcount(m_limbs.data(), m_limbs.size()));
     }
-    return ss.str();
+    return m_parity;
 }
 
-unsigned long long int Binary::to_l() const {
-    unsigned long long int i = 0;
-    for (bool b : m_bits) {
-        i = (i << 1) + b;
-    }
-    return i;
+/**
+ * Mixes the bits of `h` such that every input bit affects every output bit (MurmurHash3's finalizer)
+ */
+static std::uint64_t mix(std::uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    return h ^ (h >> 33);
 }
 
-void Binary::emplace(const std::string& s) {
-    std::vector<bool> bits;
-    for (auto &c : s) {
-        if (c == '0') {
-            bits.push_back(false);
-        } else if (c == '1') {
-            bits.push_back(true);
-        } else {
-            throw std::invalid_argument("Binary string representation must only contain '0' or '1'");
+/**
+ * Hashes `n` limbs in four independent lanes, so that the multiplications of consecutive limbs overlap
+ */
+static std::uint64_t hash_limbs(const std::uint64_t* a, std::size_t n, std::uint64_t seed) {
+    constexpr std::uint64_t K = 0x9e3779b97f4a7c15ULL;
+    std::uint64_t lanes[4] = { seed, seed + K, seed + 2 * K, seed + 3 * K };
+    const auto step = [](std::uint64_t h, std::uint64_t l) {
+        h = (h ^ l) * K;
+        return h ^ (h >> 29);
+    };
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (std::size_t j = 0; j < 4; j++) {
+            lanes[j] = step(lanes[j], a[i + j]);
         }
     }
-    while (bits.size() > 1 && !bits.front()) {
-        bits.erase(bits.begin());
+    for (; i < n; i++) {
+        lanes[i % 4] = step(lanes[i % 4], a[i]);
+    }
+    std::uint64_t h = n;
+    for (const std::uint64_t lane : lanes) {
+        h = (h ^ mix(lane)) * K;
     }
-    m_bits = bits;
+    return mix(h);
 }
 
-std::vector<bool> Binary::combine(const Binary& other, std::function<bool(bool,bool)> combiner) const {
-    std::vector<bool> bits1 = this->m_bits;
-    std::vector<bool> bits2 = other.m_bits;
-
-    size_t l = std::max(bits1.size(), bits2.size());
-
-    while (bits1.size() < l) {
-        bits1.insert(bits1.begin(), false);
+std::size_t Binary::hash() const {
+    if (!m_hash) {
+        // `0` and `1` hash as a single limb of width 1, which makes `0` and the *empty* number equal
+        const std::uint64_t low = limb(0);
+        const std::uint64_t h = m_size > 1 ? hash_limbs(m_limbs.data(), m_limbs.size(), m_size) : hash_limbs(&low, 1, 1);
+        m_hash = static_cast<std::size_t>(h);
     }
-    while (bits2.size() < l) {
-        bits2.insert(bits2.begin(), false);
+    return m_hash;
+}
+
+std::string Binary::to_str() const {
+    std::string s(m_size, '0');
+    if (m_size) {
+        kernels::format_bits(&s[0], m_limbs.data(), m_size);
     }
+    return s;
+}
 
-    for (size_t i = 0; i < l; i++) {
-        bits1[i] = combiner(bits1[i], bits2[i]);
+bool Binary::write(int fd) const {
+    struct Target {
+        int fd;
+        bool ok;
+    } target { fd, true };
+    write_chunks([](void* context, const char* chars, std::size_t n) {
+        Target& t = *static_cast<Target*>(context);
+        // `write` may accept fewer characters than requested
+        while (n && t.ok) {
+            const ssize_t written = ::write(t.fd, chars, n);
+            if (written < 0 && errno != EINTR) {
+                t.ok = false;
+            } else if (written > 0) {
+                chars += written;
+                n -= static_cast<std::size_t>(written);
+            }
+        }
+    }, &target);
+    return target.ok;
+}
+
+std::string Binary::to_dec() const {
+    return decimal::format(m_limbs.data(), m_limbs.size());
+}
+
+std::string Binary::to_hex() const {
+    return radix::format(m_limbs.data(), m_limbs.size(), 4);
+}
+
+std::string Binary::to_oct() const {
+    return radix::format(m_limbs.data(), m_limbs.size(), 3);
+}
+
+unsigned long long int Binary::to_l() const {
+    return limb(0);
+}
+
+void Binary::emplace(const std::string& s) {
+    *this = Binary(s.data(), s.size());
+}
+
+Binary& Binary::combine(const Binary& other,
+                        void (*kernel)(std::uint64_t*, const std::uint64_t*, const std::uint64_t*, std::size_t),
+                        bool keep_tail) {
+    const std::size_t size = std::max(m_size, other.m_size);
+    if (!keep_tail) {
+        m_limbs.resize(std::min(m_limbs.size(), other.m_limbs.size()));
+    } else if (m_limbs.size() < other.m_limbs.size()) {
+        // combining w/ zero limbs yields `other`'s tail for both `|` and `^`
+        m_limbs.resize(other.m_limbs.size(), 0);
     }
 
-    return bits1;
+    kernel(m_limbs.data(), m_limbs.data(), other.m_limbs.data(), std::min(m_limbs.size(), other.m_limbs.size()));
+    m_size = size;
+    normalize();
+    return *this;
 }
 
-int Binary::compare(const Binary& other) const {
-    std::vector<bool> bits1 = this->m_bits;
-    std::vector<bool> bits2 = other.m_bits;
+void Binary::save(std::ostream& os) const {
+    archive::Writer writer(os, m_size, archive::checksum(archive::CHECKSUM_SEED, m_limbs.data(), m_limbs.size()));
+    writer.write(m_limbs.data(), m_limbs.size());
+    writer.finish();
+}
 
-    size_t l = std::max(bits1.size(), bits2.size());
+Binary Binary::load(std::istream& is) {
+    archive::Reader reader(is);
+    // the limbs grow chunk by chunk rather than trusting the header's length up front
+    LimbVector limbs;
+    while (reader.remaining()) {
+        const std::size_t offset = limbs.size();
+        limbs.resize(offset + static_cast<std::size_t>(std::min<std::uint64_t>(archive::CHUNK_LIMBS, reader.remaining())));
+        reader.read(limbs.data() + offset, limbs.size() - offset);
+    }
+    return Binary(std::move(limbs), static_cast<std::size_t>(reader.bits()));
+}
 
-    while (bits1.size() < l) {
-        bits1.insert(bits1.begin(), false);
+void Binary::write_chunks(void (*sink)(void*, const char*, std::size_t), void* context) const {
+    // the digits are formatted into a fixed buffer of 128 limbs, so no string of the full width is built
+    constexpr std::size_t CHUNK_LIMBS = 128;
+    char buffer[CHUNK_LIMBS * LIMB_BITS];
+    const std::size_t head = m_size % LIMB_BITS, limbs = m_size / LIMB_BITS;
+    if (head) {
+        kernels::format_bits(buffer, m_limbs.data() + limbs, head);
+        sink(context, buffer, head);
     }
-    while (bits2.size() < l) {
-        bits2.insert(bits2.begin(), false);
+    for (std::size_t i = limbs; i > 0; ) {
+        const std::size_t count = std::min(i, CHUNK_LIMBS);
+        i -= count;
+        kernels::format_bits(buffer, m_limbs.data() + i, count * LIMB_BITS);
+        sink(context, buffer, count * LIMB_BITS);
     }
+}
 
-    int c = 0;
-    for (size_t i = 0; i < l && !c; i++) {
-        if (bits1[i] > bits2[i]) {
-            c = 1;
-        } else if (bits1[i] < bits2[i]) {
-            c = -1;
-        }
+int Binary::compare(const Binary& other) const {
+    // normalized numbers of different width cannot be equal, except for `0` and the *empty* number
+    if (m_size != other.m_size && (m_size > 1 || other.m_size > 1)) {
+        return m_size < other.m_size ? -1 : 1;
+    } else if (m_limbs.size() == other.m_limbs.size()) {
+        return arith::cmp_n(m_limbs.data(), other.m_limbs.data(), m_limbs.size());
+    } else {
+        return this->limb(0) < other.limb(0) ? -1 : this->limb(0) > other.limb(0);
     }
+}
+
+std::uint64_t Binary::limb(std::size_t i) const {
+    return i < m_limbs.size() ? m_limbs[i] : 0;
+}
 
-    return c;
+void Binary::normalize() {
+    m_parity = -1;
+    m_hash = 0;
+    if (m_size == 0) {
+        m_limbs.clear();
+        return;
+    }
+    while (m_limbs.size() > 1 && !m_limbs.back()) {
+        m_limbs.pop_back();
+    }
+    if (m_limbs.empty()) {
+        m_limbs.push_back(0);
+    }
+    m_size = std::max<std::size_t>(1, (m_limbs.size() - 1) * LIMB_BITS + bit_width(m_limbs.back()));
 }
@@ -1,9 +1,19 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
 #include <vector>
 #include <tuple>
 #include <istream>
 #include <ostream>
-#include <functional>
+#include "./cached.hpp"
+#include "./limbs.hpp"
+
+namespace lazy {
+    template<typename E> struct Expr;
+    struct Access;
+}
 
 /**
  * Representation of (unsigned) binary numbers of arbritary length
@@ -30,6 +40,61 @@ class Binary {
      */
     Binary(const std::vector<bool>& bits);
 
+    /**
+     * Constructs a Binary instance from its serialized form
+     *
+     * @example
+     *      Binary b("101", 3); // equals 101
+     *
+     * @param s the characters '0' and '1' to parse, most significant bit first
+     * @param n the number of characters
+     * @throws std::invalid_argument if `s` contains another character (naming its position)
+     */
+    Binary(const char* s, std::size_t n);
+
+    /**
+     * Constructs a Binary instance from its decimal representation, exact for any number of digits
+     *
+     * @example
+     *      Binary::from_dec("5", 1); // equals 101
+     *
+     * @param s the characters '0' to '9' to parse, most significant digit first
+     * @param n the number of characters (`0` constructs an *empty* number)
+     * @throws std::invalid_argument if `s` contains another character (naming its position)
+     */
+    static Binary from_dec(const char* s, std::size_t n);
+
+    /**
+     * Constructs a Binary instance from its hexadecimal representation
+     *
+     * @example
+     *      Binary::from_hex("1F", 2); // equals 11111
+     *
+     * @param s the characters '0' to '9', 'a' to 'f' and 'A' to 'F' to parse, most significant digit first
+     * @param n the number of characters (`0` constructs an *empty* number)
+     * @throws std::invalid_argument if `s` contains another character (naming its position)
+     */
+    static Binary from_hex(const char* s, std::size_t n);
+
+    /**
+     * Constructs a Binary instance from its octal representation
+     *
+     * @param s the characters '0' to '7' to parse, most significant digit first
+     * @param n the number of characters (`0` constructs an *empty* number)
+     * @throws std::invalid_argument if `s` contains another character (naming its position)
+     */
+    static Binary from_oct(const char* s, std::size_t n);
+
+    /**
+     * Assigns the value of a lazily evaluated bitwise expression (see `lazy.hpp`) to `this`
+     *
+     * The expression is evaluated in a single pass, reusing `this`' limbs if they have room for the result.
+     *
+     * @param expr the expression to evaluate
+     */
+    template<typename E>
+    Binary& operator=(const lazy::Expr<E>& expr);
+
     /**
      * Combines two Binary instances by bitwise application of '&'
      *
@@ -38,7 +103,14 @@ class Binary {
      * @param rhs the binary to combine with `this`
      * @returns the result of applying '&' bitwise to `this` and `rhs`
      */
-    Binary operator&(const Binary& rhs) const;
+    Binary operator&(const Binary& rhs) const &;
+
+    /**
+     * Combines `this` w/ `rhs` by bitwise application of '&', reusing `this`' limbs for the result
+     *
+     * @param rhs the binary to combine with `this`
+     */
+    Binary operator&(const Binary& rhs) &&;
 
     /**
      * Assigns the result of `this & rhs` to `this`
@@ -57,7 +129,14 @@ class Binary {
      * @param rhs the binary to combine with `this`
      * @returns the result of applying '|' bitwise to `this` and `rhs`
      */
-    Binary operator|(const Binary& rhs) const;
+    Binary operator|(const Binary& rhs) const &;
+
+    /**
+     * Combines `this` w/ `rhs` by bitwise application of '|', reusing `this`' limbs for the result
+     *
+     * @param rhs the binary to combine with `this`
+     */
+    Binary operator|(const Binary& rhs) &&;
 
     /**
      * Assigns the result of `this | rhs` to `this`
@@ -76,7 +155,14 @@ class Binary {
      * @param rhs the binary to combine with `this`
      * @returns the result of applying '^' bitwise to `this` and `rhs`
      */
-    Binary operator^(const Binary& rhs) const;
+    Binary operator^(const Binary& rhs) const &;
+
+    /**
+     * Combines `this` w/ `rhs` by bitwise application of '^', reusing `this`' limbs for the result
+     *
+     * @param rhs the binary to combine with `this`
+     */
+    Binary operator^(const Binary& rhs) &&;
 
     /**
      * Assigns the result of `this ^ rhs` to `this`
@@ -87,13 +173,71 @@ class Binary {
      */
     Binary& operator^=(const Binary& rhs);
 
+    /**
+     * Adds a binary to `this`
+     *
+     * @param rhs the summand
+     * @returns the sum of `this` and `rhs`
+     */
+    Binary operator+(const Binary& rhs) const &;
+
+    /**
+     * Adds a binary to `this`, reusing `this`' limbs for the result
+     *
+     * @param rhs the summand
+     */
+    Binary operator+(const Binary& rhs) &&;
+
+    /**
+     * Assigns the result of `this + rhs` to `this`
+     *
+     * @param rhs the summand
+     */
+    Binary& operator+=(const Binary& rhs);
+
     /**
      * Subtracts a binary from `this`
      *
      * @param rhs the subtrahend
      * @returns the result of subtracting `rhs` from this
+     * @throws std::domain_error if `rhs` is greater than `this`
+     */
+    Binary operator-(const Binary& rhs) const &;
+
+    /**
+     * Subtracts a binary from `this`, reusing `this`' limbs for the result
+     *
+     * @param rhs the subtrahend
+     * @throws std::domain_error if `rhs` is greater than `this`
+     */
+    Binary operator-(const Binary& rhs) &&;
+
+    /**
+     * Assigns the result of `this - rhs` to `this`
+     *
+     * @param rhs the subtrahend
+     * @throws std::domain_error if `rhs` is greater than `this` (`this` is left unchanged)
      */
-    Binary operator-(const Binary& rhs) const;
+    Binary& operator-=(const Binary& rhs);
+
+    /**
+     * Multiplies `this` by another binary
+     *
+     * Depending on the operands' sizes this uses schoolbook multiplication, Karatsuba, Toom-Cook 3
+     * or a number-theoretic transform (see `arith::mul_thresholds`). Squares are detected and
+     * computed by the cheaper squaring algorithms.
+     *
+     * @param rhs the factor
+     * @returns the product of `this` and `rhs`
+     */
+    Binary operator*(const Binary& rhs) const;
+
+    /**
+     * Assigns the result of `this * rhs` to `this`
+     *
+     * @param rhs the factor
+     */
+    Binary& operator*=(const Binary& rhs);
 
     /**
      * Divides `this` by another binary
@@ -113,6 +257,58 @@ class Binary {
      */
     std::tuple<Binary,Binary> div(const Binary& divisor) const;
 
+    /**
+     * Shifts `this` to the left
+     *
+     * @example
+     *      Binary b(5); // equals 101
+     *      b << 2;      // equals 10100
+     *
+     * @param n the number of bits to shift by
+     * @returns `this` multiplied by 2^n
+     */
+    Binary operator<<(std::size_t n) const &;
+
+    /**
+     * Shifts `this` to the left, reusing `this`' limbs for the result
+     *
+     * @param n the number of bits to shift by
+     */
+    Binary operator<<(std::size_t n) &&;
+
+    /**
+     * Assigns the result of `this << n` to `this`
+     *
+     * @param n the number of bits to shift by
+     */
+    Binary& operator<<=(std::size_t n);
+
+    /**
+     * Shifts `this` to the right
+     *
+     * @example
+     *      Binary b(5); // equals 101
+     *      b >> 2;      // equals 1
+     *
+     * @param n the number of bits to shift by
+     * @returns `this` divided by 2^n (w/o remainder)
+     */
+    Binary operator>>(std::size_t n) const &;
+
+    /**
+     * Shifts `this` to the right, reusing `this`' limbs for the result
+     *
+     * @param n the number of bits to shift by
+     */
+    Binary operator>>(std::size_t n) &&;
+
+    /**
+     * Assigns the result of `this >> n` to `this`
+     *
+     * @param n the number of bits to shift by
+     */
+    Binary& operator>>=(std::size_t n);
+
     /**
      * Compares `this` to binary in regards of the '>' relation
      *
@@ -156,9 +352,13 @@ class Binary {
     /**
      * Pushes a binary to an outstream in serialized form
      *
+     * The digits are binary unless `os` is set to `std::hex` or `std::oct`, `std::showbase` then
+     * prefixes them w/ "0x" or "0o".
+     *
      * @example
      *      Binary b(5); // b equals 101
      *      os << b; // writes "101" to os
+     *      os << std::hex << std::showbase << b; // writes "0x5" to os
      *
      * @param os the oustream to push to
      * @param bin the binary to push to os
@@ -188,10 +388,20 @@ class Binary {
      *      Binary b(2); // equals 10
      *      a.concat(b); // equals 10110
      *
+     * Equivalent to `(this << width of other) | other`.
+     *
+     * @param other the binary to concat to this
+     * @returns a binary representing `this` concated w/ `other`
+     */
+    Binary concat(const Binary& other) const &;
+
+    /**
+     * Concats a binary to `this`, reusing `this`' limbs for the result
+     *
      * @param other the binary to concat to this
      * @returns a binary representing `this` concated w/ `other`
      */
-    Binary concat(const Binary& other) const;
+    Binary concat(const Binary& other) &&;
 
     /**
      * Computes `this`' parity
@@ -202,10 +412,22 @@ class Binary {
      *      a.parity();  // = 1
      *      b.parity();  // = 2
      *
+     * The result is cached, so repeated calls on the same value are O(1).
+     *
      * @returns the number of _1s_ of `this`
      */
     long parity() const;
 
+    /**
+     * Computes a hash of `this`' value, consistent w/ `==` (so `0` and the *empty* number hash alike)
+     *
+     * The limbs are hashed word by word. The result is cached, so repeated calls on the same value
+     * are O(1), which also lets `==` reject numbers w/ differing cached hashes w/o comparing limbs.
+     *
+     * @returns the hash of `this`
+     */
+    std::size_t hash() const;
+
     /**
      * Converts `this`' value to number base 10
      *
@@ -226,18 +448,115 @@ class Binary {
      */
     std::string to_str() const;
 
+    /**
+     * Converts `this`' value to its exact decimal representation
+     *
+     * Unlike `to_l` this does not overflow, wide numbers are converted by divide and conquer
+     * (see `decimal.hpp`).
+     *
+     * @example
+     *      Binary b(5); // equals 101
+     *      b.to_dec(); // "5"
+     *
+     * @returns the decimal digits of `this`' value ("" if `this` is *empty*)
+     */
+    std::string to_dec() const;
+
+    /**
+     * Converts `this`' value to its hexadecimal representation (lowercase)
+     *
+     * @example
+     *      Binary b(31); // equals 11111
+     *      b.to_hex(); // "1f"
+     *
+     * @returns the hexadecimal digits of `this`' value ("" if `this` is *empty*)
+     */
+    std::string to_hex() const;
+
+    /**
+     * Converts `this`' value to its octal representation
+     *
+     * @returns the octal digits of `this`' value ("" if `this` is *empty*)
+     */
+    std::string to_oct() const;
+
+    /**
+     * Writes `this`' string representation to a file descriptor
+     *
+     * The digits are formatted and written in chunks, w/o building the full string.
+     *
+     * @param fd the file descriptor to write to
+     * @returns `false` if writing failed
+     */
+    bool write(int fd) const;
+
+    /**
+     * Writes `this` to an output stream in the compact archive format (see `archive.hpp`)
+     *
+     * The limbs are written in chunks straight from `this`, which is 8x smaller than the text form.
+     *
+     * @param os the stream to write to
+     * @throws std::runtime_error if writing fails
+     */
+    void save(std::ostream& os) const;
+
+    /**
+     * Reads a Binary instance from an input stream in the compact archive format (see `archive.hpp`)
+     *
+     * The limbs are read in chunks, the checksum is verified after the last one.
+     *
+     * @param is the stream to read from
+     * @returns the archived number
+     * @throws std::invalid_argument if the archive is malformed, truncated or corrupt
+     */
+    static Binary load(std::istream& is);
+
     private:
 
+    friend struct lazy::Access;
+
+    /**
+     * Constructs a Binary instance from digits of the radix `2^bits`
+     *
+     * @param name the name of the radix, for error messages
+     * @param digits the valid digits, for error messages
+     * @throws std::invalid_argument if `s` contains an invalid character (naming its position)
+     */
+    static Binary from_radix(const char* s, std::size_t n, unsigned int bits, const char* name, const char* digits);
+
     /**
-     * Combines `this` w/ another binary by appliying a binary function bitwise
+     * Constructs a Binary instance from a limb vector
+     *
+     * @param limbs the limbs (least significant first) that shall be represented as binary
+     * @param size the nominal number of bits of `limbs` (`0` constructs an *empty* number)
+     */
+    Binary(LimbVector limbs, std::size_t size);
+
+    /**
+     * Combines `this` w/ another binary by appliying a bitwise kernel limbwise
      *
      * Missing bits in `this` or `rhs` are treated as `false`.
      *
+     * The result is written to `this`' limbs, which only need to grow if `other` is longer and
+     * `keep_tail` is set.
+     *
      * @param other the binary to combine `this` with
-     * @param combiner the binary function used to combine two bits
-     * @returns the bit vector created by applying `combiner` on every ordered bit pair of `this` and `other`
+     * @param kernel the kernel used to combine the limbs both binaries have in common
+     * @param keep_tail whether the excess limbs of the longer binary are part of the result (`|`, `^`)
+     *                  or not (`&`)
+     * @returns a reference to `this`, now holding the result of applying `kernel` on every ordered limb pair
+     */
+    Binary& combine(const Binary& other,
+                    void (*kernel)(std::uint64_t*, const std::uint64_t*, const std::uint64_t*, std::size_t),
+                    bool keep_tail);
+
+    /**
+     * Formats `this`' string representation chunk by chunk
+     *
+     * @param sink receives `context` and every chunk of characters, the most significant first
+     * @param context passed to `sink` unchanged
      */
-    std::vector<bool> combine(const Binary& other, std::function<bool(bool,bool)> combiner) const;
+    void write_chunks(void (*sink)(void* context, const char* chars, std::size_t n), void* context) const;
 
     /**
      * Compares `this` w/ another binary by performing a bitwise comparison
@@ -252,7 +571,7 @@ class Binary {
     /**
      * Replaces the value represented by `this` by a bit sequence (in serialized form)
      * @param s the bit sequence to emplace `this`' value with
-     * @throws if `s` is no valid bit order
+     * @throws std::invalid_argument if `s` is no valid bit order (naming the first invalid position)
      *
      * @example
      *      Binary b(1);        // equals 1
@@ -262,7 +581,48 @@ class Binary {
     void emplace(const std::string& s);
 
     /**
-     * The internal bit order representing `this`' value
+     * @param i the index of the limb to read
+     * @returns the `i`-th limb of `this` or `0` if `this` has no such limb
+     */
+    std::uint64_t limb(std::size_t i) const;
+
+    /**
+     * Strips leading zero limbs and recomputes `m_size` from the most significant limb
+     *
+     * An *empty* number (`m_size == 0`) stays empty, every other number keeps at least one bit.
+     * Invalidates all cached properties of `this`, so it must be called after every modification of `m_limbs`.
+     */
+    void normalize();
+
+    /**
+     * The internal limbs representing `this`' value, least significant limb first
+     *
+     * Bits above `m_size` are always zero. Values of up to 256 bits are stored inline w/o heap allocation.
      */
-    std::vector<bool> m_bits;
+    LimbVector m_limbs;
+
+    /**
+     * The number of significant bits of `this`' value (`0` for an *empty* number)
+     */
+    std::size_t m_size;
+
+    /**
+     * The cached number of _1s_ of `this`' value, `-1` if not yet computed
+     */
+    mutable Cached<long> m_parity;
+
+    /**
+     * The cached hash of `this`' value, `0` if not yet computed (a hash of `0` is never cached)
+     */
+    mutable Cached<std::size_t> m_hash;
 };
+
+/**
+ * Hashes binaries by value, so that they can be used as keys of unordered containers
+ */
+namespace std {
+    template<>
+    struct hash<Binary> {
+        std::size_t operator()(const Binary& b) const { return b.hash(); }
+    };
+}
@@ -0,0 +1,37 @@
+#pragma once
+#include <atomic>
+
+/**
+ * A value that const member functions compute lazily and cache
+ *
+ * Unlike a plain `mutable` member the value may be read and written by several threads at once, as
+ * the standard library expects of const member functions. Loads and stores are relaxed: the cached
+ * value is derived from the owner's state alone, so concurrent writers always store the same value.
+ * Copies take a snapshot of the value, so that owners stay copyable.
+ */
+template<typename T>
+class Cached {
+    public:
+    Cached(T value) noexcept : m_value { value } {}
+
+    Cached(const Cached& other) noexcept : m_value { other.load() } {}
+
+    Cached& operator=(const Cached& other) noexcept {
+        store(other.load());
+        return *this;
+    }
+
+    Cached& operator=(T value) noexcept {
+        store(value);
+        return *this;
+    }
+
+    operator T() const noexcept { return load(); }
+
+    T load() const noexcept { return m_value.load(std::memory_order_relaxed); }
+
+    void store(T value) noexcept { m_value.store(value, std::memory_order_relaxed); }
+
+    private:
+    std::atomic<T> m_value;
+};
@@ -0,0 +1,463 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include "./fixed.hpp"
+#include "./parser.hpp"
+
+/**
+ * Compile-time evaluation of calculator expressions
+ *
+ * A `constexpr` counterpart of `evaluate` (see `parser.hpp`): the expression is tokenized, brought
+ * into RPN by the shunting yard algorithm w/ the same `precedence` and then evaluated, all in fixed
+ * size arrays. Constant expressions are thereby evaluated by the compiler and cost nothing at
+ * runtime, errors `evaluate` would throw fail the compilation instead.
+ *
+ * Numbers are evaluated w/ `MAX_BITS` bits. `BINCALC` yields the result in its natural type:
+ * - a binary as `FixedBinary` as wide as its value (w/o leading zeros)
+ * - a division as quotient and remainder (`std::tuple` of two `FixedBinary` of the same width)
+ * - a parity as `long`
+ * - a comparison as `bool`
+ *
+ * @example
+ *      constexpr auto mask = BINCALC("(101 . 11) & 11111"); // FixedBinary<5>, equals 10111
+ *      static_assert(BINCALC("p 1011 == p 0b111"), "");
+ */
+namespace constant {
+
+    /** The number of bits expressions are evaluated with */
+    constexpr std::size_t MAX_BITS = 1024;
+
+    using Number = FixedBinary<MAX_BITS>;
+
+    /**
+     * The kinds of values an expression can evaluate to
+     */
+    enum class Kind {
+        /** A binary */
+        Bin,
+        /** The quotient and remainder of a division */
+        Quotient,
+        /** A parity */
+        Num,
+        /** The result of a comparison */
+        Bool,
+    };
+
+    /**
+     * A token or a (partial) result, the counterpart of `Token` w/o heap storage
+     *
+     * `type` tells the valid fields: `op` for operators, `bin` for binaries (and `rem` if `quotient`
+     * is set), `num` for numbers and `boolean` for bools.
+     */
+    struct Item {
+        constexpr Item()
+            : type { Token::Type::Bin }
+            , op { Op::LPar }
+            , bin {}
+            , rem {}
+            , quotient { false }
+            , num { 0 }
+            , boolean { false }
+            {}
+
+        Token::Type type;
+        Op op;
+        Number bin;
+        Number rem;
+        bool quotient;
+        long num;
+        bool boolean;
+    };
+
+    constexpr Item op_item(Op op) {
+        Item item;
+        item.type = Token::Type::Op;
+        item.op = op;
+        return item;
+    }
+
+    constexpr Item bin_item(const Number& bin) {
+        Item item;
+        item.bin = bin;
+        return item;
+    }
+
+    constexpr Item num_item(long num) {
+        Item item;
+        item.type = Token::Type::Num;
+        item.num = num;
+        return item;
+    }
+
+    constexpr Item bool_item(bool boolean) {
+        Item item;
+        item.type = Token::Type::Bool;
+        item.boolean = boolean;
+        return item;
+    }
+
+    constexpr bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+    }
+
+    /**
+     * @returns the value of digit `c` in the radix of `bits` bits per digit (`10` for decimal digits)
+     * or `-1` if `c` is no such digit
+     */
+    constexpr int digit(char c, unsigned int bits) {
+        const int value = c >= '0' && c <= '9' ? c - '0'
+            : c >= 'a' && c <= 'f' ? c - 'a' + 10
+            : c >= 'A' && c <= 'F' ? c - 'A' + 10
+            : -1;
+        return value >= 0 && value < (bits == 10 ? 10 : 1 << bits) ? value : -1;
+    }
+
+    /**
+     * Appends a digit to a number in the radix of `bits` bits per digit (`10` for decimal digits)
+     * @throws std::domain_error if the number outgrows `MAX_BITS` bits
+     */
+    constexpr Number append(const Number& n, unsigned int bits, int value) {
+        const Number d(static_cast<unsigned long long int>(value));
+        if (bits == 10) {
+            return n * Number(10) + d;
+        } else if (n != Number() && n.size() + bits > MAX_BITS) {
+            throw std::domain_error("Literal does not fit into the bits of a constant expression");
+        }
+        return (n << bits) | d;
+    }
+
+    /**
+     * Parses an expression to tokens (like `tokenize` in parser.cpp)
+     * @param out receives the tokens, an expression has fewer tokens than characters
+     * @returns the number of tokens
+     * @throws std::invalid_argument if the expression contains an invalid character or literal
+     */
+    template<std::size_t L>
+    constexpr std::size_t tokenize(const char (&s)[L], Item (&out)[L]) {
+        std::size_t n = 0;
+        // digits of the current literal, which may be interrupted by whitespace
+        Number curr;
+        bool pending = false;
+
+        for (std::size_t i = 0; i < L && s[i]; ) {
+            const char c = s[i];
+            if (is_space(c)) {
+                i++;
+                continue;
+            }
+            const char next = i + 1 < L ? s[i + 1] : '\0';
+            Op op = Op::LPar;
+            std::size_t length = 1;
+            if (c == '0' && (next == 'b' || next == 'o' || next == 'd' || next == 'x')) {
+                // a literal w/ radix prefix, e.g. '0b101', '0o17', '0d42' or '0xff'
+                if (pending) {
+                    out[n++] = bin_item(curr);
+                    curr = Number();
+                    pending = false;
+                }
+                const unsigned int bits = next == 'b' ? 1 : next == 'o' ? 3 : next == 'd' ? 10 : 4;
+                std::size_t end = i + 2;
+                Number value;
+                for (; end < L && s[end] && digit(s[end], bits) >= 0; end++) {
+                    value = append(value, bits, digit(s[end], bits));
+                }
+                if (end == i + 2) {
+                    throw std::invalid_argument("Expected digits after a radix prefix");
+                }
+                out[n++] = bin_item(value);
+                i = end;
+                continue;
+            } else if (c == '0' || c == '1') {
+                curr = append(curr, 1, c - '0');
+                pending = true;
+                i++;
+                continue;
+            } else if (c == '&') {
+                op = Op::And;
+            } else if (c == '|') {
+                op = Op::Or;
+            } else if (c == '^') {
+                op = Op::Xor;
+            } else if (c == '/') {
+                op = Op::Div;
+            } else if (c == '+') {
+                op = Op::Add;
+            } else if (c == '-') {
+                op = Op::Sub;
+            } else if (c == '*') {
+                op = Op::Mul;
+            } else if (c == '.') {
+                op = Op::Concat;
+            } else if (c == '>') {
+                op = next == '>' ? Op::Shr : Op::GT;
+                length = next == '>' ? 2 : 1;
+            } else if (c == '<') {
+                op = next == '<' ? Op::Shl : Op::LT;
+                length = next == '<' ? 2 : 1;
+            } else if ((c == '=' || c == '!') && next == '=') {
+                op = c == '=' ? Op::EQ : Op::NEQ;
+                length = 2;
+            } else if (c == '=' || c == '!') {
+                throw std::invalid_argument("Invalid input character. Expected '='");
+            } else if (c == 'p') {
+                op = Op::Parity;
+            } else if (c == '(') {
+                op = Op::LPar;
+            } else if (c == ')') {
+                op = Op::RPar;
+            } else {
+                throw std::invalid_argument("Invalid input character");
+            }
+            if (pending) {
+                out[n++] = bin_item(curr);
+                curr = Number();
+                pending = false;
+            }
+            out[n++] = op_item(op);
+            i += length;
+        }
+        if (pending) {
+            out[n++] = bin_item(curr);
+        }
+        return n;
+    }
+
+    /**
+     * Brings tokens into RPN by the shunting yard algorithm (like `evaluate` in parser.cpp)
+     * @param out receives the RPN, which has no more tokens than the input
+     * @returns the number of RPN tokens
+     * @throws std::invalid_argument if parentheses do not match
+     */
+    template<std::size_t L>
+    constexpr std::size_t to_rpn(const Item (&input)[L], std::size_t n, Item (&out)[L]) {
+        Op operators[L] = {};
+        std::size_t count = 0, ops = 0;
+        for (std::size_t i = 0; i < n; i++) {
+            const Item& t = input[i];
+            if (t.type == Token::Type::Bin) {
+                out[count++] = t;
+            } else if (t.op == Op::LPar) {
+                operators[ops++] = t.op;
+            } else if (t.op == Op::RPar) {
+                while (ops && operators[ops - 1] != Op::LPar) {
+                    out[count++] = op_item(operators[--ops]);
+                }
+                if (!ops) {
+                    throw std::invalid_argument("Bad expression. Found ')' without matching '('");
+                }
+                ops--; // pop '('
+            } else {
+                while (ops && precedence(t.op) <= precedence(operators[ops - 1])) {
+                    out[count++] = op_item(operators[--ops]);
+                }
+                operators[ops++] = t.op;
+            }
+        }
+        while (ops) {
+            const Op op = operators[--ops];
+            if (op == Op::LPar) {
+                throw std::invalid_argument("Bad expression. Found '(' without matching ')'");
+            }
+            out[count++] = op_item(op);
+        }
+        return count;
+    }
+
+    /**
+     * Applies a binary operator to its operands (like the RPN evaluation in parser.cpp)
+     * @throws std::invalid_argument if the operands' types do not fit the operator
+     * @throws std::domain_error if the operation is undefined or outgrows `MAX_BITS` bits
+     */
+    constexpr Item apply(Op op, const Item& lhs, const Item& rhs) {
+        const bool bins = lhs.type == Token::Type::Bin && rhs.type == Token::Type::Bin;
+        const bool nums = lhs.type == Token::Type::Num && rhs.type == Token::Type::Num;
+        const bool bools = lhs.type == Token::Type::Bool && rhs.type == Token::Type::Bool;
+        const Number& a = lhs.bin;
+        const Number& b = rhs.bin;
+        if (op == Op::EQ || op == Op::NEQ) {
+            if (!bins && !nums && !bools) {
+                throw std::invalid_argument("Cannot compare operands of different types");
+            }
+            const bool equal = bins ? a == b : nums ? lhs.num == rhs.num : lhs.boolean == rhs.boolean;
+            return bool_item(op == Op::EQ ? equal : !equal);
+        } else if (op == Op::GT || op == Op::LT) {
+            if (!bins && !nums) {
+                throw std::invalid_argument("Cannot order operands other than two binaries or two numbers");
+            }
+            const bool less = bins ? (op == Op::LT ? a < b : b < a) : (op == Op::LT ? lhs.num < rhs.num : rhs.num < lhs.num);
+            return bool_item(less);
+        } else if (!bins) {
+            throw std::invalid_argument("Cannot perform a binary operation on operands other than binaries");
+        }
+
+        switch (op) {
+            case Op::And:
+                return bin_item(a & b);
+            case Op::Or:
+                return bin_item(a | b);
+            case Op::Xor:
+                return bin_item(a ^ b);
+            case Op::Add:
+                return bin_item(a + b);
+            case Op::Sub:
+                return bin_item(a - b);
+            case Op::Mul:
+                return bin_item(a * b);
+            case Op::Div: {
+                const std::tuple<Number, Number> result = a.div(b);
+                Item item = bin_item(std::get<0>(result));
+                // like `Binary::div`, which takes a divisor larger than the dividend as the remainder
+                item.rem = b > a ? b : std::get<1>(result);
+                item.quotient = true;
+                return item;
+            }
+            case Op::Shl:
+            case Op::Shr: {
+                // amounts beyond the width shift out every bit
+                const std::size_t n = b < Number(MAX_BITS) ? static_cast<std::size_t>(b.to_l()) : MAX_BITS;
+                if (op == Op::Shl && a != Number() && a.size() + n > MAX_BITS) {
+                    throw std::domain_error("Shift result does not fit into the bits of a constant expression");
+                }
+                return bin_item(op == Op::Shl ? a << n : a >> n);
+            }
+            case Op::Concat: {
+                // like `Binary::concat`, `b` takes as many bits as it has w/o leading zeros
+                if (a != Number() && a.size() + b.size() > MAX_BITS) {
+                    throw std::domain_error("Concatenation does not fit into the bits of a constant expression");
+                }
+                return bin_item((a << b.size()) | b);
+            }
+            default:
+                throw std::invalid_argument("Unknown operator");
+        }
+    }
+
+    /**
+     * Evaluates an expression
+     * @returns the expression's final value
+     * @throws std::invalid_argument if the expression is misformed in terms of syntax or types
+     * @throws std::domain_error if an operation is undefined or outgrows `MAX_BITS` bits
+     */
+    template<std::size_t L>
+    constexpr Item evaluate(const char (&s)[L]) {
+        Item tokens[L] = {};
+        Item rpn[L] = {};
+        const std::size_t count = to_rpn(tokens, tokenize(s, tokens), rpn);
+
+        // value tokens are pushed to the stack, operator tokens pop their arguments and push the result
+        Item stack[L] = {};
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < count; i++) {
+            const Item& t = rpn[i];
+            if (t.type != Token::Type::Op) {
+                stack[n++] = t;
+            } else if (t.op == Op::Parity) {
+                if (n < 1 || stack[n - 1].type != Token::Type::Bin) {
+                    throw std::invalid_argument("Cannot perform 'p(arity)' w/o a binary operand");
+                }
+                stack[n - 1] = num_item(stack[n - 1].bin.parity());
+            } else {
+                if (n < 2) {
+                    throw std::invalid_argument("Operation is applied to too few arguments");
+                }
+                stack[n - 2] = apply(t.op, stack[n - 2], stack[n - 1]);
+                n--;
+            }
+        }
+        if (n != 1) {
+            throw std::invalid_argument("Expression cannot be evaluated to a single value");
+        }
+        return stack[0];
+    }
+
+    /**
+     * The kind and width of an expression's value, which determine its type
+     */
+    struct Shape {
+        Kind kind;
+        std::size_t width;
+    };
+
+    /**
+     * @returns the shape of an expression's value, the width of binaries w/o leading zeros
+     */
+    template<std::size_t L>
+    constexpr Shape shape(const char (&s)[L]) {
+        const Item value = evaluate(s);
+        switch (value.type) {
+            case Token::Type::Num:
+                return Shape { Kind::Num, 1 };
+            case Token::Type::Bool:
+                return Shape { Kind::Bool, 1 };
+            default:
+                return value.quotient
+                    ? Shape { Kind::Quotient, std::max(value.bin.size(), value.rem.size()) }
+                    : Shape { Kind::Bin, value.bin.size() };
+        }
+    }
+
+    /**
+     * Converts an expression's value to the type of its shape
+     */
+    template<Kind K, std::size_t W>
+    struct Result;
+
+    template<std::size_t W>
+    struct Result<Kind::Bin, W> {
+        using type = FixedBinary<W>;
+        static constexpr type convert(const Item& value) { return type(value.bin); }
+    };
+
+    template<std::size_t W>
+    struct Result<Kind::Quotient, W> {
+        using type = std::tuple<FixedBinary<W>, FixedBinary<W>>;
+        static constexpr type convert(const Item& value) { return type(FixedBinary<W>(value.bin), FixedBinary<W>(value.rem)); }
+    };
+
+    template<std::size_t W>
+    struct Result<Kind::Num, W> {
+        using type = long;
+        static constexpr type convert(const Item& value) { return value.num; }
+    };
+
+    template<std::size_t W>
+    struct Result<Kind::Bool, W> {
+        using type = bool;
+        static constexpr type convert(const Item& value) { return value.boolean; }
+    };
+
+    /**
+     * @returns the shape of an expression's value packed into a single integer, so that a template
+     * argument list may take it from one evaluation instead of one per member (see `evaluate_as`)
+     */
+    template<std::size_t L>
+    constexpr std::size_t packed_shape(const char (&s)[L]) {
+        const Shape result = shape(s);
+        return result.width * 4 + static_cast<std::size_t>(result.kind);
+    }
+
+    /**
+     * The result of the packed shape `P` (see `packed_shape`)
+     */
+    template<std::size_t P>
+    using PackedResult = Result<static_cast<Kind>(P % 4), P / 4>;
+
+    /**
+     * Evaluates an expression to a value of the type given by its packed shape (see `BINCALC`)
+     */
+    template<std::size_t P, std::size_t L>
+    constexpr typename PackedResult<P>::type evaluate_as(const char (&s)[L]) {
+        return PackedResult<P>::convert(evaluate(s));
+    }
+}
+
+/**
+ * Evaluates a calculator expression (a string literal) at compile time when used in a constant
+ * expression, e.g. to initialize a `constexpr` variable
+ *
+ * @returns the value as `FixedBinary`, `std::tuple` of quotient and remainder, `long` or `bool`
+ * (see `constant`)
+ */
+#define BINCALC(expr) (::constant::evaluate_as<::constant::packed_shape(expr)>(expr))
@@ -0,0 +1,174 @@
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include "./decimal.hpp"
+#include "./arith.hpp"
+#include "./arena.hpp"
+
+/** The largest power of ten that fits into a limb, numbers are converted in chunks of its digits */
+static constexpr std::uint64_t CHUNK = 10000000000000000000ULL;
+
+/** The number of decimal digits per chunk */
+static constexpr std::size_t CHUNK_DIGITS = 19;
+
+/**
+ * Numbers of up to `2^BASE_LEVEL` chunks (608 digits, about 32 limbs) are converted chunk by chunk,
+ * larger ones are split at a power of ten
+ */
+static constexpr std::size_t BASE_LEVEL = 5;
+
+/**
+ * Strips leading zero limbs
+ */
+static void trim(LimbVector& a) {
+    while (!a.empty() && !a.back()) {
+        a.pop_back();
+    }
+}
+
+/**
+ * @returns `10^(19 * 2^k)`, computed once by repeated squaring and cached afterwards
+ */
+static const LimbVector& power(std::size_t k) {
+    // a deque keeps references to its elements valid while it grows
+    static std::mutex mutex;
+    static std::deque<LimbVector> powers;
+    std::lock_guard<std::mutex> lock(mutex);
+    // the cache outlives the expression being evaluated and thus any arena
+    Arena::Suspend heap;
+    while (powers.size() <= k) {
+        if (powers.empty()) {
+            powers.push_back(LimbVector { CHUNK });
+        } else {
+            const LimbVector& p = powers.back();
+            LimbVector square(2 * p.size());
+            arith::sqr(square.data(), p.data(), p.size());
+            trim(square);
+            powers.push_back(std::move(square));
+        }
+    }
+    return powers[k];
+}
+
+/**
+ * Writes the 19 digits of `chunk < 10^19` to `out`, zero-padded
+ */
+static void format_chunk(std::uint64_t chunk, char* out) {
+    for (std::size_t i = CHUNK_DIGITS; i-- > 0; ) {
+        out[i] = static_cast<char>('0' + chunk % 10);
+        chunk /= 10;
+    }
+}
+
+/**
+ * Writes the `19 * 2^k` digits of `a < 10^(19 * 2^k)` to `out`, zero-padded
+ *
+ * `a` is consumed.
+ */
+static void format_level(LimbVector& a, std::size_t k, char* out) {
+    trim(a);
+    const std::size_t digits = CHUNK_DIGITS << k;
+    if (a.empty()) {
+        std::fill(out, out + digits, '0');
+    } else if (k <= BASE_LEVEL) {
+        // the least significant chunk is split off first
+        for (std::size_t i = std::size_t { 1 } << k; i-- > 0; ) {
+            format_chunk(a.empty() ? 0 : arith::divrem_1(a.data(), a.data(), a.size(), CHUNK), out + CHUNK_DIGITS * i);
+            trim(a);
+        }
+    } else {
+        const LimbVector& p = power(k - 1);
+        if (a.size() < p.size()) {
+            std::fill(out, out + digits / 2, '0');
+            format_level(a, k - 1, out + digits / 2);
+        } else {
+            LimbVector q(a.size() - p.size() + 1), r(p.size());
+            arith::divrem(q.data(), r.data(), a.data(), a.size(), p.data(), p.size());
+            format_level(q, k - 1, out);
+            format_level(r, k - 1, out + digits / 2);
+        }
+    }
+}
+
+std::string decimal::format(const std::uint64_t* a, std::size_t n) {
+    if (!n) {
+        return "";
+    }
+    // `a < 2^(64n) < 10^(20n)`, which determines the level to start at
+    std::size_t k = 0;
+    while ((CHUNK_DIGITS << k) < 20 * n) {
+        k++;
+    }
+    LimbVector x(n);
+    std::copy(a, a + n, x.data());
+    std::string digits(CHUNK_DIGITS << k, '0');
+    format_level(x, k, &digits[0]);
+
+    const std::size_t first = std::min(digits.find_first_not_of('0'), digits.size() - 1);
+    return digits.substr(first);
+}
+
+/**
+ * Parses `n` digits chunk by chunk, the leading chunk may be shorter than 19 digits
+ */
+static LimbVector parse_base(const char* s, std::size_t n) {
+    LimbVector a { 0 };
+    std::size_t len = n % CHUNK_DIGITS ? n % CHUNK_DIGITS : CHUNK_DIGITS;
+    for (std::size_t i = 0; i < n; i += len, len = CHUNK_DIGITS) {
+        std::uint64_t chunk = 0;
+        for (std::size_t j = i; j < i + len; j++) {
+            chunk = chunk * 10 + static_cast<std::uint64_t>(s[j] - '0');
+        }
+        // a = a * 10^19 + chunk, which fits into one more limb
+        const std::uint64_t carry = arith::mul_1(a.data(), a.data(), a.size(), CHUNK);
+        const std::uint64_t top = carry + arith::add(a.data(), a.data(), a.size(), &chunk, 1);
+        if (top) {
+            a.push_back(top);
+        }
+    }
+    return a;
+}
+
+/**
+ * Parses `n` digits by splitting off the lower `19 * 2^k` digits
+ */
+static LimbVector parse_level(const char* s, std::size_t n) {
+    if (n <= CHUNK_DIGITS << BASE_LEVEL) {
+        return parse_base(s, n);
+    }
+    std::size_t k = BASE_LEVEL;
+    while ((CHUNK_DIGITS << (k + 1)) < n) {
+        k++;
+    }
+    const std::size_t low_digits = CHUNK_DIGITS << k;
+    LimbVector high = parse_level(s, n - low_digits), low = parse_level(s + n - low_digits, low_digits);
+    trim(high);
+    trim(low);
+    const LimbVector& p = power(k);
+
+    // a = high * 10^(19 * 2^k) + low, where `low` is less than the power
+    LimbVector a(high.size() + p.size() + 1, 0);
+    if (!high.empty()) {
+        arith::mul(a.data(), p.data(), p.size(), high.data(), high.size());
+    }
+    if (!low.empty()) {
+        arith::add(a.data(), a.data(), a.size(), low.data(), low.size());
+    }
+    return a;
+}
+
+LimbVector decimal::parse(const char* s, std::size_t n) {
+    LimbVector a = parse_level(s, n);
+    if (a.empty()) {
+        a.push_back(0);
+    }
+    return a;
+}
+
+std::size_t decimal::find_invalid(const char* s, std::size_t n) {
+    std::size_t i = 0;
+    while (i < n && s[i] >= '0' && s[i] <= '9') {
+        i++;
+    }
+    return i;
+}
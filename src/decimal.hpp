@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "./limbs.hpp"
+
+/**
+ * Conversion between numbers on limb arrays (least significant limb first) and decimal digits
+ *
+ * Both directions split the number at cached powers `10^(19 * 2^k)` and recurse on the halves, so
+ * large conversions cost a few multiplications / divisions of the full size instead of a quadratic
+ * number of single limb steps.
+ */
+namespace decimal {
+
+    /**
+     * Formats a number of `n` limbs as decimal digits
+     *
+     * @returns the digits w/o leading zeros ("0" for zero, "" for `n == 0`)
+     */
+    std::string format(const std::uint64_t* a, std::size_t n);
+
+    /**
+     * Parses `n` decimal digits
+     *
+     * @param s the characters '0' to '9', the most significant digit first
+     * @returns the limbs of the parsed number (not normalized)
+     */
+    LimbVector parse(const char* s, std::size_t n);
+
+    /**
+     * @returns the position of the first character in `s` that is no decimal digit, `n` if there is none
+     */
+    std::size_t find_invalid(const char* s, std::size_t n);
+}
@@ -0,0 +1,473 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include "./binary.hpp"
+#include "./lazy.hpp"
+
+/**
+ * Representation of (unsigned) binary numbers of exactly `N` bits
+ *
+ * The limbs are stored inside the object, so values never allocate, need no normalization and are
+ * literal types: every operation is `constexpr` and is evaluated at compile time for constant
+ * operands, all others compile to straight-line code over `LIMBS` limbs. As the width is fixed,
+ * the bitwise NOT is well-defined, it flips exactly `N` bits.
+ *
+ * Bits above `N` are always zero. Operations keep the width, except for `concat`, whose result is
+ * as wide as both operands together. Arithmetic throws if its result outgrows the width, shifts
+ * drop the bits shifted out. Arithmetic of unbounded width goes through Binary (see `to_binary`).
+ *
+ * @example
+ *      constexpr auto key = 1010_b;            // FixedBinary<4>
+ *      constexpr auto both = key.concat(~key); // FixedBinary<8>, equals 10100101
+ *      static_assert(both.parity() == 4, "");
+ */
+template<std::size_t N>
+class FixedBinary {
+    static_assert(N > 0, "FixedBinary must have at least one bit");
+
+    template<std::size_t> friend class FixedBinary;
+
+    public:
+    /** The number of limbs holding the value */
+    static constexpr std::size_t LIMBS = (N + 63) / 64;
+
+    /**
+     * Constructs the number `0`
+     */
+    constexpr FixedBinary() : m_limbs {} {}
+
+    /**
+     * Constructs a FixedBinary instance from a digit of base 10
+     * @param n the number (of base 10) that shall be represented as binary
+     * @throws std::domain_error if `n` does not fit into `N` bits
+     */
+    constexpr FixedBinary(unsigned long long int n) : m_limbs {} {
+        if (N < 64 && n >> (N % 64)) {
+            throw std::domain_error("Value does not fit into " + std::to_string(N) + " bits");
+        }
+        m_limbs[0] = n;
+    }
+
+    /**
+     * Widens a narrower number, which is always lossless
+     */
+    template<std::size_t M, typename = typename std::enable_if<(M < N)>::type>
+    constexpr FixedBinary(const FixedBinary<M>& other) : m_limbs {} {
+        for (std::size_t i = 0; i < FixedBinary<M>::LIMBS; i++) {
+            m_limbs[i] = other.m_limbs[i];
+        }
+    }
+
+    /**
+     * Narrows a wider number
+     * @throws std::domain_error if `other` does not fit into `N` bits
+     */
+    template<std::size_t M, typename = typename std::enable_if<(M > N)>::type, typename = void>
+    constexpr explicit FixedBinary(const FixedBinary<M>& other) : m_limbs {} {
+        if (other.size() > N) {
+            throw std::domain_error("Value does not fit into " + std::to_string(N) + " bits");
+        }
+        for (std::size_t i = 0; i < LIMBS; i++) {
+            m_limbs[i] = other.m_limbs[i];
+        }
+    }
+
+    /**
+     * Constructs a FixedBinary instance from a bit sequence, most significant bit first
+     * @param s the bits, only the characters '0' and '1' are allowed (leading zeros may exceed `N`)
+     * @param n the number of bits
+     * @throws std::invalid_argument if `s` contains another character (naming its position)
+     * @throws std::domain_error if the value does not fit into `N` bits
+     */
+    constexpr FixedBinary(const char* s, std::size_t n) : m_limbs {} {
+        for (std::size_t i = 0; i < n; i++) {
+            if (s[i] != '0' && s[i] != '1') {
+                throw std::invalid_argument("Binary string representation must only contain '0' or '1', found '"
+                                            + std::string(1, s[i]) + "' at position " + std::to_string(i));
+            }
+        }
+        for (std::size_t i = 0; i < n; i++) {
+            if (s[n - 1 - i] == '1') {
+                if (i >= N) {
+                    throw std::domain_error("Value does not fit into " + std::to_string(N) + " bits");
+                }
+                m_limbs[i / 64] |= std::uint64_t { 1 } << (i % 64);
+            }
+        }
+    }
+
+    /**
+     * Converts a Binary
+     * @throws std::domain_error if `b` has more than `N` significant bits
+     */
+    explicit FixedBinary(const Binary& b) : m_limbs {} {
+        if (lazy::Access::size(b) > N) {
+            throw std::domain_error("Value does not fit into " + std::to_string(N) + " bits");
+        }
+        const LimbVector& limbs = lazy::Access::limbs(b);
+        for (std::size_t i = 0; i < limbs.size(); i++) {
+            m_limbs[i] = limbs[i];
+        }
+    }
+
+    /**
+     * @returns the same value as a Binary (w/o leading zeros)
+     */
+    Binary to_binary() const {
+        LimbVector limbs(LIMBS);
+        for (std::size_t i = 0; i < LIMBS; i++) {
+            limbs[i] = m_limbs[i];
+        }
+        Binary result;
+        lazy::Access::assign(result, std::move(limbs), N);
+        return result;
+    }
+
+    constexpr FixedBinary operator&(const FixedBinary& rhs) const { return FixedBinary(*this) &= rhs; }
+
+    constexpr FixedBinary& operator&=(const FixedBinary& rhs) {
+        for (std::size_t i = 0; i < LIMBS; i++) {
+            m_limbs[i] &= rhs.m_limbs[i];
+        }
+        return *this;
+    }
+
+    constexpr FixedBinary operator|(const FixedBinary& rhs) const { return FixedBinary(*this) |= rhs; }
+
+    constexpr FixedBinary& operator|=(const FixedBinary& rhs) {
+        for (std::size_t i = 0; i < LIMBS; i++) {
+            m_limbs[i] |= rhs.m_limbs[i];
+        }
+        return *this;
+    }
+
+    constexpr FixedBinary operator^(const FixedBinary& rhs) const { return FixedBinary(*this) ^= rhs; }
+
+    constexpr FixedBinary& operator^=(const FixedBinary& rhs) {
+        for (std::size_t i = 0; i < LIMBS; i++) {
+            m_limbs[i] ^= rhs.m_limbs[i];
+        }
+        return *this;
+    }
+
+    /**
+     * @returns `this` w/ all `N` bits flipped
+     */
+    constexpr FixedBinary operator~() const {
+        FixedBinary result;
+        for (std::size_t i = 0; i < LIMBS; i++) {
+            result.m_limbs[i] = ~m_limbs[i];
+        }
+        result.m_limbs[LIMBS - 1] &= TOP_MASK;
+        return result;
+    }
+
+    /**
+     * @throws std::domain_error if the sum does not fit into `N` bits
+     */
+    constexpr FixedBinary operator+(const FixedBinary& rhs) const {
+        FixedBinary result;
+        std::uint64_t carry = 0;
+        for (std::size_t i = 0; i < LIMBS; i++) {
+            const std::uint64_t sum = m_limbs[i] + rhs.m_limbs[i];
+            result.m_limbs[i] = sum + carry;
+            carry = (sum < m_limbs[i]) | (result.m_limbs[i] < sum);
+        }
+        if (carry || result.m_limbs[LIMBS - 1] & ~TOP_MASK) {
+            throw std::domain_error("Sum does not fit into " + std::to_string(N) + " bits");
+        }
+        return result;
+    }
+
+    /**
+     * @throws std::domain_error if the sum does not fit into `N` bits (`this` is left unchanged)
+     */
+    constexpr FixedBinary& operator+=(const FixedBinary& rhs) { return *this = *this + rhs; }
+
+    /**
+     * @throws std::domain_error if `rhs` is greater than `this`
+     */
+    constexpr FixedBinary operator-(const FixedBinary& rhs) const {
+        if (*this < rhs) {
+            throw std::domain_error("Subtraction result is negative");
+        }
+        FixedBinary result(*this);
+        result.subtract(rhs);
+        return result;
+    }
+
+    /**
+     * @throws std::domain_error if `rhs` is greater than `this` (`this` is left unchanged)
+     */
+    constexpr FixedBinary& operator-=(const FixedBinary& rhs) { return *this = *this - rhs; }
+
+    /**
+     * Multiplies by the schoolbook method, which is the fastest for the few limbs of fixed widths
+     * @throws std::domain_error if the product does not fit into `N` bits
+     */
+    constexpr FixedBinary operator*(const FixedBinary& rhs) const {
+        std::uint64_t product[2 * LIMBS] = {};
+        for (std::size_t i = 0; i < LIMBS; i++) {
+            std::uint64_t carry = 0;
+            for (std::size_t j = 0; j < LIMBS; j++) {
+                const uint128 p = static_cast<uint128>(m_limbs[i]) * rhs.m_limbs[j] + product[i + j] + carry;
+                product[i + j] = static_cast<std::uint64_t>(p);
+                carry = static_cast<std::uint64_t>(p >> 64);
+            }
+            product[i + LIMBS] = carry;
+        }
+        FixedBinary result;
+        bool overflow = product[LIMBS - 1] & ~TOP_MASK;
+        for (std::size_t i = 0; i < LIMBS; i++) {
+            result.m_limbs[i] = product[i];
+            overflow |= product[LIMBS + i] != 0;
+        }
+        if (overflow) {
+            throw std::domain_error("Product does not fit into " + std::to_string(N) + " bits");
+        }
+        return result;
+    }
+
+    /**
+     * @throws std::domain_error if the product does not fit into `N` bits (`this` is left unchanged)
+     */
+    constexpr FixedBinary& operator*=(const FixedBinary& rhs) { return *this = *this * rhs; }
+
+    /**
+     * Shifts `this` to the left, bits shifted beyond `N` are dropped
+     */
+    constexpr FixedBinary operator<<(std::size_t n) const { return FixedBinary(*this) <<= n; }
+
+    constexpr FixedBinary& operator<<=(std::size_t n) {
+        // from the top, so that every limb is read before it is overwritten
+        const std::size_t words = n / 64;
+        const unsigned int bits = static_cast<unsigned int>(n % 64);
+        for (std::size_t i = LIMBS; i-- > 0; ) {
+            std::uint64_t l = 0;
+            if (i >= words) {
+                l = m_limbs[i - words] << bits;
+                if (bits && i > words) {
+                    l |= m_limbs[i - words - 1] >> (64 - bits);
+                }
+            }
+            m_limbs[i] = l;
+        }
+        m_limbs[LIMBS - 1] &= TOP_MASK;
+        return *this;
+    }
+
+    constexpr FixedBinary operator>>(std::size_t n) const { return FixedBinary(*this) >>= n; }
+
+    constexpr FixedBinary& operator>>=(std::size_t n) {
+        const std::size_t words = n / 64;
+        const unsigned int bits = static_cast<unsigned int>(n % 64);
+        for (std::size_t i = 0; i < LIMBS; i++) {
+            std::uint64_t l = 0;
+            if (i + words < LIMBS) {
+                l = m_limbs[i + words] >> bits;
+                if (bits && i + words + 1 < LIMBS) {
+                    l |= m_limbs[i + words + 1] << (64 - bits);
+                }
+            }
+            m_limbs[i] = l;
+        }
+        return *this;
+    }
+
+    /**
+     * Divides `this` by `divisor`
+     * @returns the quotient and the remainder
+     * @throws std::domain_error if `divisor` equals zero
+     */
+    constexpr std::tuple<FixedBinary, FixedBinary> div(const FixedBinary& divisor) const {
+        if (divisor == FixedBinary()) {
+            throw std::domain_error("Division by 0");
+        }
+        FixedBinary q, r;
+        if (LIMBS == 1) {
+            q.m_limbs[0] = m_limbs[0] / divisor.m_limbs[0];
+            r.m_limbs[0] = m_limbs[0] % divisor.m_limbs[0];
+            return std::make_tuple(q, r);
+        }
+        // restoring division bit by bit, the remainder's bit shifted out above `N` is kept in `carry`;
+        // the remainder stays zero while the leading zeros are shifted in, so they are skipped
+        for (std::size_t i = size(); i-- > 0; ) {
+            const bool carry = r.bit(N - 1);
+            r <<= 1;
+            r.m_limbs[0] |= bit(i);
+            if (carry || !(r < divisor)) {
+                r.subtract(divisor);
+                q.m_limbs[i / 64] |= std::uint64_t { 1 } << (i % 64);
+            }
+        }
+        return std::make_tuple(q, r);
+    }
+
+    /**
+     * @throws std::domain_error if `divisor` equals zero
+     */
+    constexpr FixedBinary operator/(const FixedBinary& divisor) const { return std::get<0>(div(divisor)); }
+
+    constexpr bool operator>(const FixedBinary& rhs) const { return compare(rhs) > 0; }
+
+    constexpr bool operator<(const FixedBinary& rhs) const { return compare(rhs) < 0; }
+
+    constexpr bool operator==(const FixedBinary& rhs) const { return compare(rhs) == 0; }
+
+    constexpr bool operator!=(const FixedBinary& rhs) const { return compare(rhs) != 0; }
+
+    /**
+     * Concatenates `this` w/ another fixed binary
+     * @param other the number that makes up the low `M` bits of the result
+     * @returns the number of `N + M` bits w/ `this` in the high bits
+     */
+    template<std::size_t M>
+    constexpr FixedBinary<N + M> concat(const FixedBinary<M>& other) const {
+        FixedBinary<N + M> result(*this);
+        result <<= M;
+        for (std::size_t i = 0; i < FixedBinary<M>::LIMBS; i++) {
+            result.m_limbs[i] |= other.m_limbs[i];
+        }
+        return result;
+    }
+
+    /**
+     * @returns the number of _1s_ of `this`
+     */
+    constexpr long parity() const {
+        long ones = 0;
+        for (std::size_t i = 0; i < LIMBS; i++) {
+            ones += __builtin_popcountll(m_limbs[i]);
+        }
+        return ones;
+    }
+
+    /**
+     * @returns the number of bits of the value, w/o leading zeros (but at least 1, like Binary)
+     */
+    constexpr std::size_t size() const {
+        for (std::size_t i = LIMBS; i-- > 1; ) {
+            if (m_limbs[i]) {
+                return 64 * i + 64 - static_cast<std::size_t>(__builtin_clzll(m_limbs[i]));
+            }
+        }
+        return m_limbs[0] ? 64 - static_cast<std::size_t>(__builtin_clzll(m_limbs[0])) : 1;
+    }
+
+    /**
+     * @returns the lowest 64 bits of `this` as an integer
+     */
+    constexpr unsigned long long int to_l() const { return m_limbs[0]; }
+
+    /**
+     * @returns all `N` bits of `this` (including leading zeros), most significant bit first
+     */
+    std::string to_str() const {
+        std::string s(N, '0');
+        for (std::size_t i = 0; i < N; i++) {
+            if (bit(i)) {
+                s[N - 1 - i] = '1';
+            }
+        }
+        return s;
+    }
+
+    /**
+     * Prints all `N` bits of `bin` to `os`
+     */
+    friend std::ostream& operator<<(std::ostream& os, const FixedBinary& bin) {
+        return os << bin.to_str();
+    }
+
+    private:
+    __extension__ typedef unsigned __int128 uint128;
+
+    /** The bits of the most significant limb that belong to the value */
+    static constexpr std::uint64_t TOP_MASK = N % 64 ? (std::uint64_t { 1 } << (N % 64)) - 1 : ~std::uint64_t { 0 };
+
+    /**
+     * @returns the `i`-th bit of `this`
+     */
+    constexpr bool bit(std::size_t i) const {
+        return (m_limbs[i / 64] >> (i % 64)) & 1;
+    }
+
+    /**
+     * @returns 0 if `this` and `other` are equivalent, < 0, if `this` is less than `other`, > 0 otherwise
+     */
+    constexpr int compare(const FixedBinary& other) const {
+        for (std::size_t i = LIMBS; i-- > 0; ) {
+            if (m_limbs[i] != other.m_limbs[i]) {
+                return m_limbs[i] < other.m_limbs[i] ? -1 : 1;
+            }
+        }
+        return 0;
+    }
+
+    /**
+     * Subtracts `other` modulo 2^N
+     */
+    constexpr void subtract(const FixedBinary& other) {
+        std::uint64_t borrow = 0;
+        for (std::size_t i = 0; i < LIMBS; i++) {
+            const std::uint64_t d = m_limbs[i] - other.m_limbs[i];
+            const std::uint64_t next = (m_limbs[i] < other.m_limbs[i]) | (d < borrow);
+            m_limbs[i] = d - borrow;
+            borrow = next;
+        }
+        m_limbs[LIMBS - 1] &= TOP_MASK;
+    }
+
+    /**
+     * The limbs representing `this`' value, least significant limb first
+     */
+    std::uint64_t m_limbs[LIMBS];
+};
+
+/**
+ * Helpers of the `_b` literal
+ */
+namespace fixed_literal {
+
+    constexpr std::size_t digits() { return 0; }
+
+    /**
+     * @returns the number of binary digits, w/o digit separators
+     */
+    template<typename... Cs>
+    constexpr std::size_t digits(char c, Cs... cs) { return (c == '\'' ? 0 : 1) + digits(cs...); }
+
+    constexpr bool valid() { return true; }
+
+    /**
+     * @returns whether all characters are binary digits or digit separators
+     */
+    template<typename... Cs>
+    constexpr bool valid(char c, Cs... cs) { return (c == '0' || c == '1' || c == '\'') && valid(cs...); }
+}
+
+/**
+ * A fixed binary literal, as wide as it has digits
+ *
+ * @example
+ *      101_b           // FixedBinary<3>
+ *      0000'1111_b     // FixedBinary<8>, digit separators are skipped
+ */
+template<char... Cs>
+constexpr FixedBinary<fixed_literal::digits(Cs...)> operator""_b() {
+    static_assert(fixed_literal::valid(Cs...), "A _b literal must only contain the digits 0 and 1");
+    constexpr std::size_t n = fixed_literal::digits(Cs...);
+    const char chars[] = { Cs... };
+    char bits[n] = {};
+    for (std::size_t i = 0, j = 0; i < sizeof...(Cs); i++) {
+        if (chars[i] != '\'') {
+            bits[j++] = chars[i];
+        }
+    }
+    return FixedBinary<n>(bits, n);
+}
@@ -0,0 +1,530 @@
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <vector>
+#include "./kernels.hpp"
+#include "./parallel.hpp"
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define KERNELS_X86 1
+#endif
+
+/** Signature shared by all limbwise bitwise kernels */
+using BitwiseKernel = void (*)(std::uint64_t*, const std::uint64_t*, const std::uint64_t*, std::size_t);
+
+/** Signature shared by all popcount kernels */
+using PopcountKernel = std::uint64_t (*)(const std::uint64_t*, std::size_t);
+
+/** Signature shared by all kernels parsing 64 character chunks of a binary literal */
+using ParseKernel = std::size_t (*)(std::uint64_t*, const char*, std::size_t);
+
+/** Signature shared by all kernels formatting limbs as 64 characters each */
+using FormatKernel = void (*)(char*, const std::uint64_t*, std::size_t);
+
+/**
+ * Limbwise '&'
+ */
+struct And {
+    static std::uint64_t scalar(std::uint64_t a, std::uint64_t b) { return a & b; }
+#ifdef KERNELS_X86
+    static __m128i sse2(__m128i a, __m128i b) { return _mm_and_si128(a, b); }
+    __attribute__((target("avx2"))) static __m256i avx2(__m256i a, __m256i b) { return _mm256_and_si256(a, b); }
+    __attribute__((target("avx512f"))) static __m512i avx512(__m512i a, __m512i b) { return _mm512_and_si512(a, b); }
+#endif
+};
+
+/**
+ * Limbwise '|'
+ */
+struct Or {
+    static std::uint64_t scalar(std::uint64_t a, std::uint64_t b) { return a | b; }
+#ifdef KERNELS_X86
+    static __m128i sse2(__m128i a, __m128i b) { return _mm_or_si128(a, b); }
+    __attribute__((target("avx2"))) static __m256i avx2(__m256i a, __m256i b) { return _mm256_or_si256(a, b); }
+    __attribute__((target("avx512f"))) static __m512i avx512(__m512i a, __m512i b) { return _mm512_or_si512(a, b); }
+#endif
+};
+
+/**
+ * Limbwise '^'
+ */
+struct Xor {
+    static std::uint64_t scalar(std::uint64_t a, std::uint64_t b) { return a ^ b; }
+#ifdef KERNELS_X86
+    static __m128i sse2(__m128i a, __m128i b) { return _mm_xor_si128(a, b); }
+    __attribute__((target("avx2"))) static __m256i avx2(__m256i a, __m256i b) { return _mm256_xor_si256(a, b); }
+    __attribute__((target("avx512f"))) static __m512i avx512(__m512i a, __m512i b) { return _mm512_xor_si512(a, b); }
+#endif
+};
+
+template<typename O>
+static void bitwise_scalar(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n) {
+    for (std::size_t i = 0; i < n; i++) {
+        r[i] = O::scalar(a[i], b[i]);
+    }
+}
+
+#ifdef KERNELS_X86
+
+template<typename O>
+static void bitwise_sse2(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 2 <= n; i += 2) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(r + i), O::sse2(x, y));
+    }
+    bitwise_scalar<O>(r + i, a + i, b + i, n - i);
+}
+
+template<typename O>
+__attribute__((target("avx2")))
+static void bitwise_avx2(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256i x0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        const __m256i y0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        const __m256i x1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i + 4));
+        const __m256i y1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i + 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i), O::avx2(x0, y0));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(r + i + 4), O::avx2(x1, y1));
+    }
+    bitwise_sse2<O>(r + i, a + i, b + i, n - i);
+}
+
+template<typename O>
+__attribute__((target("avx512f")))
+static void bitwise_avx512(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n) {
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m512i x0 = _mm512_loadu_si512(a + i);
+        const __m512i y0 = _mm512_loadu_si512(b + i);
+        const __m512i x1 = _mm512_loadu_si512(a + i + 8);
+        const __m512i y1 = _mm512_loadu_si512(b + i + 8);
+        _mm512_storeu_si512(r + i, O::avx512(x0, y0));
+        _mm512_storeu_si512(r + i + 8, O::avx512(x1, y1));
+    }
+    if (i < n) {
+        // mask the tail instead of falling back to narrower vectors
+        const __mmask8 lo = static_cast<__mmask8>(n - i >= 8 ? 0xff : (1u << (n - i)) - 1);
+        const __mmask8 hi = static_cast<__mmask8>(n - i <= 8 ? 0 : (1u << (n - i - 8)) - 1);
+        const __m512i x0 = _mm512_maskz_loadu_epi64(lo, a + i);
+        const __m512i y0 = _mm512_maskz_loadu_epi64(lo, b + i);
+        const __m512i x1 = _mm512_maskz_loadu_epi64(hi, a + i + 8);
+        const __m512i y1 = _mm512_maskz_loadu_epi64(hi, b + i + 8);
+        _mm512_mask_storeu_epi64(r + i, lo, O::avx512(x0, y0));
+        _mm512_mask_storeu_epi64(r + i + 8, hi, O::avx512(x1, y1));
+    }
+}
+
+#endif
+
+static std::uint64_t popcount_scalar(const std::uint64_t* a, std::size_t n) {
+    std::uint64_t c = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        c += static_cast<std::uint64_t>(__builtin_popcountll(a[i]));
+    }
+    return c;
+}
+
+#ifdef KERNELS_X86
+
+__attribute__((target("popcnt")))
+static std::uint64_t popcount_popcnt(const std::uint64_t* a, std::size_t n) {
+    // four independent accumulators hide the latency of `popcnt`
+    std::uint64_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        c0 += static_cast<std::uint64_t>(__builtin_popcountll(a[i]));
+        c1 += static_cast<std::uint64_t>(__builtin_popcountll(a[i + 1]));
+        c2 += static_cast<std::uint64_t>(__builtin_popcountll(a[i + 2]));
+        c3 += static_cast<std::uint64_t>(__builtin_popcountll(a[i + 3]));
+    }
+    for (; i < n; i++) {
+        c0 += static_cast<std::uint64_t>(__builtin_popcountll(a[i]));
+    }
+    return c0 + c1 + c2 + c3;
+}
+
+/**
+ * Counts the bits of every 64 bit lane of `v` by looking up the counts of both nibbles of every byte
+ */
+__attribute__((target("avx2")))
+static __m256i popcount_lanes_avx2(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    const __m256i lo = _mm256_and_si256(v, low_mask);
+    const __m256i hi = _mm256_and_si256(_mm256_srli_epi32(v, 4), low_mask);
+    const __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+}
+
+/**
+ * Carry-save adder: adds the bits of `a`, `b` and `c` into a sum (`l`) and a carry (`h`) bit
+ */
+__attribute__((target("avx2")))
+static void csa_avx2(__m256i& h, __m256i& l, __m256i a, __m256i b, __m256i c) {
+    const __m256i u = _mm256_xor_si256(a, b);
+    h = _mm256_or_si256(_mm256_and_si256(a, b), _mm256_and_si256(u, c));
+    l = _mm256_xor_si256(u, c);
+}
+
+__attribute__((target("avx2,popcnt")))
+static std::uint64_t popcount_avx2(const std::uint64_t* a, std::size_t n) {
+    if (n < 64) {
+        return popcount_popcnt(a, n);
+    }
+
+    // Harley-Seal: 16 vectors are reduced by a carry-save adder network, so only one in
+    // 16 vectors needs an actual population count
+    const __m256i* v = reinterpret_cast<const __m256i*>(a);
+    __m256i total = _mm256_setzero_si256();
+    __m256i ones = _mm256_setzero_si256(), twos = ones, fours = ones, eights = ones, sixteens;
+    __m256i twos_a, twos_b, fours_a, fours_b, eights_a, eights_b;
+    const std::size_t vectors = n / 4;
+    std::size_t i = 0;
+    for (; i + 16 <= vectors; i += 16) {
+        csa_avx2(twos_a, ones, ones, _mm256_loadu_si256(v + i), _mm256_loadu_si256(v + i + 1));
+        csa_avx2(twos_b, ones, ones, _mm256_loadu_si256(v + i + 2), _mm256_loadu_si256(v + i + 3));
+        csa_avx2(fours_a, twos, twos, twos_a, twos_b);
+        csa_avx2(twos_a, ones, ones, _mm256_loadu_si256(v + i + 4), _mm256_loadu_si256(v + i + 5));
+        csa_avx2(twos_b, ones, ones, _mm256_loadu_si256(v + i + 6), _mm256_loadu_si256(v + i + 7));
+        csa_avx2(fours_b, twos, twos, twos_a, twos_b);
+        csa_avx2(eights_a, fours, fours, fours_a, fours_b);
+        csa_avx2(twos_a, ones, ones, _mm256_loadu_si256(v + i + 8), _mm256_loadu_si256(v + i + 9));
+        csa_avx2(twos_b, ones, ones, _mm256_loadu_si256(v + i + 10), _mm256_loadu_si256(v + i + 11));
+        csa_avx2(fours_a, twos, twos, twos_a, twos_b);
+        csa_avx2(twos_a, ones, ones, _mm256_loadu_si256(v + i + 12), _mm256_loadu_si256(v + i + 13));
+        csa_avx2(twos_b, ones, ones, _mm256_loadu_si256(v + i + 14), _mm256_loadu_si256(v + i + 15));
+        csa_avx2(fours_b, twos, twos, twos_a, twos_b);
+        csa_avx2(eights_b, fours, fours, fours_a, fours_b);
+        csa_avx2(sixteens, eights, eights, eights_a, eights_b);
+        total = _mm256_add_epi64(total, popcount_lanes_avx2(sixteens));
+    }
+    total = _mm256_slli_epi64(total, 4);
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount_lanes_avx2(eights), 3));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount_lanes_avx2(fours), 2));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount_lanes_avx2(twos), 1));
+    total = _mm256_add_epi64(total, popcount_lanes_avx2(ones));
+    for (; i < vectors; i++) {
+        total = _mm256_add_epi64(total, popcount_lanes_avx2(_mm256_loadu_si256(v + i)));
+    }
+
+    alignas(32) std::uint64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + popcount_popcnt(a + 4 * vectors, n - 4 * vectors);
+}
+
+__attribute__((target("avx512f,avx512vpopcntdq")))
+static std::uint64_t popcount_avx512(const std::uint64_t* a, std::size_t n) {
+    __m512i total0 = _mm512_setzero_si512(), total1 = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        total0 = _mm512_add_epi64(total0, _mm512_popcnt_epi64(_mm512_loadu_si512(a + i)));
+        total1 = _mm512_add_epi64(total1, _mm512_popcnt_epi64(_mm512_loadu_si512(a + i + 8)));
+    }
+    for (; i < n; i += 8) {
+        const __mmask8 mask = static_cast<__mmask8>(n - i >= 8 ? 0xff : (1u << (n - i)) - 1);
+        total0 = _mm512_add_epi64(total0, _mm512_popcnt_epi64(_mm512_maskz_loadu_epi64(mask, a + i)));
+    }
+    alignas(64) std::uint64_t lanes[8];
+    _mm512_store_si512(lanes, _mm512_add_epi64(total0, total1));
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] + lanes[7];
+}
+
+#endif
+
+/**
+ * Parses up to 64 characters of a binary literal one by one
+ *
+ * @param limb receives the bits, the first character being the most significant one
+ * @returns `false` if a character other than '0' and '1' was found
+ */
+static bool parse_chars(const char* p, std::size_t n, std::uint64_t& limb) {
+    std::uint64_t l = 0;
+    for (std::size_t i = 0; i < n; i++) {
+        if (p[i] != '0' && p[i] != '1') {
+            return false;
+        }
+        l = (l << 1) | static_cast<std::uint64_t>(p[i] == '1');
+    }
+    limb = l;
+    return true;
+}
+
+/**
+ * Reverses the order of the bits of `x`
+ */
+static std::uint64_t reverse_bits(std::uint64_t x) {
+    x = __builtin_bswap64(x);
+    x = ((x >> 4) & 0x0f0f0f0f0f0f0f0f) | ((x & 0x0f0f0f0f0f0f0f0f) << 4);
+    x = ((x >> 2) & 0x3333333333333333) | ((x & 0x3333333333333333) << 2);
+    return ((x >> 1) & 0x5555555555555555) | ((x & 0x5555555555555555) << 1);
+}
+
+/**
+ * Parses `chunks` chunks of 64 characters, the first chunk holding the most significant limb
+ *
+ * Eight characters are validated and packed at once by SWAR: a valid byte only differs from '0' in
+ * its lowest bit, and a multiplication gathers the lowest bits of all bytes in the top byte.
+ *
+ * @param r the array of `chunks` limbs receiving the bits
+ * @returns the index of the first chunk holding an invalid character, `chunks` if there is none
+ */
+static std::size_t parse_scalar(std::uint64_t* r, const char* s, std::size_t chunks) {
+    for (std::size_t c = 0; c < chunks; c++) {
+        const char* p = s + 64 * c;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        std::uint64_t limb = 0, invalid = 0;
+        for (std::size_t k = 0; k < 8; k++) {
+            std::uint64_t x;
+            std::memcpy(&x, p + 8 * k, 8);
+            invalid |= (x & 0xfefefefefefefefe) ^ 0x3030303030303030;
+            limb = (limb << 8) | (((x & 0x0101010101010101) * 0x8040201008040201) >> 56);
+        }
+        if (invalid) {
+            return c;
+        }
+        r[chunks - 1 - c] = limb;
+#else
+        if (!parse_chars(p, 64, r[chunks - 1 - c])) {
+            return c;
+        }
+#endif
+    }
+    return chunks;
+}
+
+#ifdef KERNELS_X86
+
+static std::size_t parse_sse2(std::uint64_t* r, const char* s, std::size_t chunks) {
+    const __m128i mask = _mm_set1_epi8(static_cast<char>(0xfe)), zero = _mm_set1_epi8('0');
+    for (std::size_t c = 0; c < chunks; c++) {
+        const char* p = s + 64 * c;
+        std::uint64_t bits = 0;
+        unsigned int valid = 0xffff;
+        for (std::size_t k = 0; k < 4; k++) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * k));
+            valid &= static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(v, mask), zero)));
+            // moves each character's lowest bit to the top of its byte, where `movemask` picks it up
+            bits |= static_cast<std::uint64_t>(static_cast<unsigned int>(_mm_movemask_epi8(_mm_slli_epi64(v, 7)))) << (16 * k);
+        }
+        if (valid != 0xffff) {
+            return c;
+        }
+        r[chunks - 1 - c] = reverse_bits(bits);
+    }
+    return chunks;
+}
+
+__attribute__((target("avx2")))
+static std::size_t parse_avx2(std::uint64_t* r, const char* s, std::size_t chunks) {
+    const __m256i mask = _mm256_set1_epi8(static_cast<char>(0xfe)), zero = _mm256_set1_epi8('0');
+    for (std::size_t c = 0; c < chunks; c++) {
+        const char* p = s + 64 * c;
+        const __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        const __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32));
+        const __m256i valid = _mm256_and_si256(_mm256_cmpeq_epi8(_mm256_and_si256(v0, mask), zero),
+                                               _mm256_cmpeq_epi8(_mm256_and_si256(v1, mask), zero));
+        if (_mm256_movemask_epi8(valid) != -1) {
+            return c;
+        }
+        const std::uint64_t bits = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_slli_epi64(v0, 7)))
+            | static_cast<std::uint64_t>(static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_slli_epi64(v1, 7)))) << 32;
+        r[chunks - 1 - c] = reverse_bits(bits);
+    }
+    return chunks;
+}
+
+#endif
+
+/**
+ * The characters of every byte value, most significant bit first (as little endian 64 bit word)
+ */
+static const std::uint64_t* format_table() {
+    static const struct Table {
+        std::uint64_t chars[256];
+        Table() : chars {} {
+            for (unsigned int b = 0; b < 256; b++) {
+                char c[8];
+                for (unsigned int i = 0; i < 8; i++) {
+                    c[i] = (b >> (7 - i)) & 1 ? '1' : '0';
+                }
+                std::memcpy(&chars[b], c, 8);
+            }
+        }
+    } table;
+    return table.chars;
+}
+
+/**
+ * Formats `n` limbs as 64 characters each, the most significant limb and bit first
+ *
+ * Every byte is expanded to eight characters by a table lookup.
+ */
+static void format_scalar(char* out, const std::uint64_t* a, std::size_t n) {
+    const std::uint64_t* table = format_table();
+    for (std::size_t i = n; i-- > 0; ) {
+        const std::uint64_t l = a[i];
+        for (unsigned int k = 8; k-- > 0; ) {
+            std::memcpy(out, &table[(l >> (8 * k)) & 0xff], 8);
+            out += 8;
+        }
+    }
+}
+
+#ifdef KERNELS_X86
+
+__attribute__((target("avx2")))
+static void format_avx2(char* out, const std::uint64_t* a, std::size_t n) {
+    // byte `k` of a 32 bit word is spread to characters `8k` to `8k + 7`, which test one bit each
+    const __m256i spread = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1,
+                                            2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+    const __m256i bits = _mm256_set1_epi64x(static_cast<long long>(0x8040201008040201));
+    const __m256i zero = _mm256_set1_epi8('0');
+    for (std::size_t i = n; i-- > 0; ) {
+        // reversing the bits puts the most significant bit to the lowest position, i.e. the first character
+        const std::uint64_t l = reverse_bits(a[i]);
+        for (unsigned int half = 0; half < 2; half++) {
+            const __m256i v = _mm256_shuffle_epi8(_mm256_set1_epi32(static_cast<int>(l >> (32 * half))), spread);
+            const __m256i set = _mm256_cmpeq_epi8(_mm256_and_si256(v, bits), bits);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_sub_epi8(zero, set));
+            out += 32;
+        }
+    }
+}
+
+#endif
+
+/**
+ * The kernel implementations the public kernels currently dispatch to
+ */
+struct KernelTable {
+    kernels::Isa isa;
+    BitwiseKernel and_n;
+    BitwiseKernel or_n;
+    BitwiseKernel xor_n;
+    PopcountKernel popcount;
+    ParseKernel parse;
+    FormatKernel format;
+};
+
+/**
+ * @returns the kernel implementations for `isa`
+ */
+static KernelTable table_for(kernels::Isa isa) {
+    switch (isa) {
+#ifdef KERNELS_X86
+        case kernels::Isa::AVX512:
+            return { isa, bitwise_avx512<And>, bitwise_avx512<Or>, bitwise_avx512<Xor>,
+                     __builtin_cpu_supports("avx512vpopcntdq") ? popcount_avx512 : popcount_avx2, parse_avx2, format_avx2 };
+        case kernels::Isa::AVX2:
+            return { isa, bitwise_avx2<And>, bitwise_avx2<Or>, bitwise_avx2<Xor>, popcount_avx2, parse_avx2, format_avx2 };
+        case kernels::Isa::SSE2:
+            return { isa, bitwise_sse2<And>, bitwise_sse2<Or>, bitwise_sse2<Xor>,
+                     __builtin_cpu_supports("popcnt") ? popcount_popcnt : popcount_scalar, parse_sse2, format_scalar };
+#endif
+        default:
+            return { kernels::Isa::Scalar, bitwise_scalar<And>, bitwise_scalar<Or>, bitwise_scalar<Xor>, popcount_scalar, parse_scalar, format_scalar };
+    }
+}
+
+/**
+ * @returns the table of kernel implementations in use, initialized for the detected isa
+ */
+static KernelTable& table() {
+    static KernelTable t = table_for(kernels::detected_isa());
+    return t;
+}
+
+kernels::Isa kernels::detected_isa() {
+#ifdef KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return Isa::AVX512;
+    } else if (__builtin_cpu_supports("avx2")) {
+        return Isa::AVX2;
+    } else if (__builtin_cpu_supports("sse2")) {
+        return Isa::SSE2;
+    }
+#endif
+    return Isa::Scalar;
+}
+
+kernels::Isa kernels::active_isa() {
+    return table().isa;
+}
+
+kernels::Isa kernels::use_isa(Isa isa) {
+    table() = table_for(std::min(isa, detected_isa()));
+    return table().isa;
+}
+
+/**
+ * Applies a bitwise kernel, large operands are split into chunks across the thread pool
+ */
+static void bitwise(BitwiseKernel kernel, std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n) {
+    if (!parallel::worthwhile(n)) {
+        kernel(r, a, b, n);
+        return;
+    }
+    const std::size_t chunk = parallel::chunk_limbs;
+    parallel::for_each((n + chunk - 1) / chunk, [=](std::size_t i) {
+        const std::size_t offset = i * chunk;
+        kernel(r + offset, a + offset, b + offset, std::min(chunk, n - offset));
+    });
+}
+
+void kernels::and_n(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n) {
+    bitwise(table().and_n, r, a, b, n);
+}
+
+void kernels::or_n(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n) {
+    bitwise(table().or_n, r, a, b, n);
+}
+
+void kernels::xor_n(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n) {
+    bitwise(table().xor_n, r, a, b, n);
+}
+
+std::uint64_t kernels::popcount(const std::uint64_t* a, std::size_t n) {
+    const PopcountKernel kernel = table().popcount;
+    if (!parallel::worthwhile(n)) {
+        return kernel(a, n);
+    }
+    // every chunk's count goes to its own slot, which are summed up afterwards
+    const std::size_t chunk = parallel::chunk_limbs, chunks = (n + chunk - 1) / chunk;
+    std::vector<std::uint64_t> counts(chunks);
+    parallel::for_each(chunks, [&](std::size_t i) {
+        const std::size_t offset = i * chunk;
+        counts[i] = kernel(a + offset, std::min(chunk, n - offset));
+    });
+    return std::accumulate(counts.begin(), counts.end(), std::uint64_t { 0 });
+}
+
+std::size_t kernels::parse_bits(std::uint64_t* r, const char* s, std::size_t n) {
+    // the leading characters that do not fill a whole limb form the most significant limb
+    const std::size_t head = n % 64, chunks = n / 64;
+    std::size_t invalid = 0;
+    if (!head || parse_chars(s, head, r[chunks])) {
+        const std::size_t chunk = table().parse(r, s + head, chunks);
+        if (chunk == chunks) {
+            return n;
+        }
+        invalid = head + 64 * chunk;
+    }
+    while (s[invalid] == '0' || s[invalid] == '1') {
+        invalid++;
+    }
+    return invalid;
+}
+
+void kernels::format_bits(char* out, const std::uint64_t* a, std::size_t n) {
+    const std::size_t head = n % 64, limbs = n / 64;
+    for (std::size_t i = head; i-- > 0; ) {
+        *out++ = (a[limbs] >> i) & 1 ? '1' : '0';
+    }
+    table().format(out, a, limbs);
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Low level kernels working on raw limb arrays (least significant limb first)
+ *
+ * Every kernel is available in several implementations that make use of the instruction set
+ * extensions of the running CPU. The fastest supported implementation is picked at runtime.
+ */
+namespace kernels {
+
+    /**
+     * Instruction set extensions a kernel implementation may be based on
+     */
+    enum class Isa {
+        /** Portable C++ implementation */
+        Scalar,
+        /** x86 SSE2 (128 bit vectors) */
+        SSE2,
+        /** x86 AVX2 (256 bit vectors) */
+        AVX2,
+        /** x86 AVX-512F (512 bit vectors) */
+        AVX512,
+    };
+
+    /**
+     * @returns the most capable instruction set extension supported by the running CPU
+     */
+    Isa detected_isa();
+
+    /**
+     * @returns the instruction set extension the kernels currently dispatch to
+     */
+    Isa active_isa();
+
+    /**
+     * Makes the kernels dispatch to the implementations for `isa`
+     *
+     * If `isa` is not supported by the running CPU the most capable supported one is used instead.
+     * Meant for testing and benchmarking, must not be called while kernels are running.
+     *
+     * @param isa the instruction set extension to use
+     * @returns the instruction set extension that is actually used
+     */
+    Isa use_isa(Isa isa);
+
+    /**
+     * Computes `r[i] = a[i] & b[i]` for `i` in `[0, n)`
+     *
+     * `r` may alias `a` or `b`.
+     */
+    void and_n(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n);
+
+    /**
+     * Computes `r[i] = a[i] | b[i]` for `i` in `[0, n)`
+     *
+     * `r` may alias `a` or `b`.
+     */
+    void or_n(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n);
+
+    /**
+     * Computes `r[i] = a[i] ^ b[i]` for `i` in `[0, n)`
+     *
+     * `r` may alias `a` or `b`.
+     */
+    void xor_n(std::uint64_t* r, const std::uint64_t* a, const std::uint64_t* b, std::size_t n);
+
+    /**
+     * Counts the bits set in `a[0]` to `a[n - 1]`
+     *
+     * Depending on the instruction set this uses the `popcnt` instruction, a Harley-Seal
+     * carry-save adder network over AVX2 nibble lookups or AVX-512 `vpopcntq`.
+     *
+     * @returns the number of 1s in the `n` limbs starting at `a`
+     */
+    std::uint64_t popcount(const std::uint64_t* a, std::size_t n);
+
+    /**
+     * Parses a binary literal of `n` characters '0' and '1', the most significant bit first
+     *
+     * Depending on the instruction set 16 or 32 characters are validated and packed per step by
+     * comparisons and `movemask`, otherwise 8 characters per step by SWAR arithmetic.
+     *
+     * @param r the array of `ceil(n / 64)` limbs receiving the bits (least significant limb first)
+     * @returns `n` if the literal is valid, the position of its first invalid character otherwise
+     *          (`r` is left in an unspecified state then)
+     */
+    std::size_t parse_bits(std::uint64_t* r, const char* s, std::size_t n);
+
+    /**
+     * Formats the lowest `n` bits of `a` as characters '0' and '1', the most significant bit first
+     *
+     * Depending on the instruction set 32 characters are produced per step by AVX2 byte shuffles
+     * and comparisons, otherwise 8 characters per step by a table lookup.
+     *
+     * @param out the array of `n` characters receiving the digits (w/o terminating '\0')
+     * @param a the array of `ceil(n / 64)` limbs to format (least significant limb first)
+     */
+    void format_bits(char* out, const std::uint64_t* a, std::size_t n);
+}
@@ -0,0 +1,254 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include "./binary.hpp"
+#include "./limbs.hpp"
+
+/**
+ * Expression templates for Binary's bitwise operators
+ *
+ * Wrapping an operand in `lazy::ref` makes `&`, `|` and `^` build an expression tree instead of
+ * computing temporaries. The tree is evaluated when it is converted or assigned to a Binary, in a
+ * single pass over the limbs that computes every result limb from the operands' limbs at once.
+ *
+ * @example
+ *      Binary r = (lazy::ref(a) & b) ^ (lazy::ref(c) | d); // one pass, no temporaries
+ *      r = lazy::ref(r) & mask;                             // reuses r's limbs
+ *
+ * Expressions only hold references to their operands, so they must be evaluated in the
+ * full-expression that creates them and must not be stored (e.g. in an `auto` variable).
+ */
+namespace lazy {
+
+    /**
+     * Grants the expression templates access to Binary's limbs
+     */
+    struct Access {
+        static const LimbVector& limbs(const Binary& b) { return b.m_limbs; }
+
+        static std::size_t size(const Binary& b) { return b.m_size; }
+
+        /**
+         * Replaces `b`'s value by `limbs` and normalizes it
+         */
+        static void assign(Binary& b, LimbVector&& limbs, std::size_t size) {
+            b.m_limbs = std::move(limbs);
+            b.m_size = size;
+            b.normalize();
+        }
+
+        /**
+         * @returns `b`'s limbs for writing, `finish` must be called afterwards
+         */
+        static LimbVector& target(Binary& b) { return b.m_limbs; }
+
+        /**
+         * Sets `b`'s nominal size after its limbs have been written and normalizes it
+         */
+        static void finish(Binary& b, std::size_t size) {
+            b.m_size = size;
+            b.normalize();
+        }
+    };
+
+    /**
+     * Base of all expressions (CRTP), `E` must provide
+     * - `limbs()`: the number of limbs of the result (before normalization)
+     * - `size()`: the nominal number of bits of the result (`0` if all operands are *empty*)
+     * - `covers(n)`: whether every operand has at least `n` limbs
+     * - `at(i)`: the `i`-th result limb, if `covers(i + 1)`
+     * - `get(i)`: the `i`-th result limb, treating missing operand limbs as `0`
+     */
+    template<typename E>
+    struct Expr {
+        const E& self() const { return static_cast<const E&>(*this); }
+
+        /**
+         * Evaluates the expression
+         */
+        operator Binary() const;
+    };
+
+    /**
+     * A Binary operand (leaf of an expression tree)
+     */
+    class Ref : public Expr<Ref> {
+        public:
+        explicit Ref(const Binary& b)
+            : m_data { Access::limbs(b).data() }
+            , m_limbs { Access::limbs(b).size() }
+            , m_size { Access::size(b) }
+            {}
+
+        /**
+         * Wraps a number stored outside of a Binary (e.g. a `BinaryView`)
+         *
+         * @param data the number's limbs, least significant first
+         * @param limbs the number of limbs
+         * @param size the nominal number of bits
+         */
+        Ref(const std::uint64_t* data, std::size_t limbs, std::size_t size)
+            : m_data { data }
+            , m_limbs { limbs }
+            , m_size { size }
+            {}
+
+        std::size_t limbs() const { return m_limbs; }
+        std::size_t size() const { return m_size; }
+        bool covers(std::size_t n) const { return n <= m_limbs; }
+        std::uint64_t at(std::size_t i) const { return m_data[i]; }
+        std::uint64_t get(std::size_t i) const { return i < m_limbs ? m_data[i] : 0; }
+
+        private:
+        const std::uint64_t* m_data;
+        std::size_t m_limbs;
+        std::size_t m_size;
+    };
+
+    /** Limbwise '&', the result is no longer than the shorter operand */
+    struct And {
+        static std::uint64_t apply(std::uint64_t a, std::uint64_t b) { return a & b; }
+        static std::size_t limbs(std::size_t a, std::size_t b) { return std::min(a, b); }
+    };
+
+    /** Limbwise '|', the result is as long as the longer operand */
+    struct Or {
+        static std::uint64_t apply(std::uint64_t a, std::uint64_t b) { return a | b; }
+        static std::size_t limbs(std::size_t a, std::size_t b) { return std::max(a, b); }
+    };
+
+    /** Limbwise '^', the result is as long as the longer operand */
+    struct Xor {
+        static std::uint64_t apply(std::uint64_t a, std::uint64_t b) { return a ^ b; }
+        static std::size_t limbs(std::size_t a, std::size_t b) { return std::max(a, b); }
+    };
+
+    /**
+     * An inner node of an expression tree applying `Op` to the results of `L` and `R`
+     */
+    template<typename Op, typename L, typename R>
+    class Node : public Expr<Node<Op, L, R> > {
+        public:
+        Node(const L& l, const R& r) : m_l { l }, m_r { r } {}
+
+        std::size_t limbs() const { return Op::limbs(m_l.limbs(), m_r.limbs()); }
+        std::size_t size() const { return std::max(m_l.size(), m_r.size()); }
+        bool covers(std::size_t n) const { return m_l.covers(n) && m_r.covers(n); }
+        std::uint64_t at(std::size_t i) const { return Op::apply(m_l.at(i), m_r.at(i)); }
+        std::uint64_t get(std::size_t i) const { return Op::apply(m_l.get(i), m_r.get(i)); }
+
+        private:
+        L m_l;
+        R m_r;
+    };
+
+    /**
+     * Wraps `b` so that bitwise operators applied to it are evaluated lazily
+     */
+    inline Ref ref(const Binary& b) {
+        return Ref(b);
+    }
+
+    /**
+     * Writes the limbs `[0, n)` of `e` to `r`
+     *
+     * `r` may alias an operand's limbs, as every limb is only computed from operand limbs of the same index.
+     */
+    template<typename E>
+    void evaluate(std::uint64_t* r, const E& expr, std::size_t n) {
+        // a local copy of the tree (operand pointers and sizes only) lets the compiler keep it in registers
+        const E e = expr;
+        // full blocks that are covered by every operand run w/o bound checks and w/ a constant trip
+        // count, which lets them vectorize
+        constexpr std::size_t BLOCK = 64;
+        for (std::size_t i = 0; i < n; i += BLOCK) {
+            if (i + BLOCK <= n && e.covers(i + BLOCK)) {
+                std::uint64_t* block = r + i;
+#if defined(__clang__)
+#pragma clang loop vectorize(assume_safety)
+#elif defined(__GNUC__)
+#pragma GCC ivdep
+#endif
+                for (std::size_t j = 0; j < BLOCK; j++) {
+                    block[j] = e.at(i + j);
+                }
+            } else {
+                for (std::size_t j = i; j < std::min(n, i + BLOCK); j++) {
+                    r[j] = e.get(j);
+                }
+            }
+        }
+    }
+
+    template<typename E>
+    Expr<E>::operator Binary() const {
+        Binary result;
+        result = *this;
+        return result;
+    }
+
+    template<typename L, typename R>
+    Node<And, L, R> operator&(const Expr<L>& l, const Expr<R>& r) {
+        return { l.self(), r.self() };
+    }
+
+    template<typename L>
+    Node<And, L, Ref> operator&(const Expr<L>& l, const Binary& r) {
+        return { l.self(), Ref(r) };
+    }
+
+    template<typename R>
+    Node<And, Ref, R> operator&(const Binary& l, const Expr<R>& r) {
+        return { Ref(l), r.self() };
+    }
+
+    template<typename L, typename R>
+    Node<Or, L, R> operator|(const Expr<L>& l, const Expr<R>& r) {
+        return { l.self(), r.self() };
+    }
+
+    template<typename L>
+    Node<Or, L, Ref> operator|(const Expr<L>& l, const Binary& r) {
+        return { l.self(), Ref(r) };
+    }
+
+    template<typename R>
+    Node<Or, Ref, R> operator|(const Binary& l, const Expr<R>& r) {
+        return { Ref(l), r.self() };
+    }
+
+    template<typename L, typename R>
+    Node<Xor, L, R> operator^(const Expr<L>& l, const Expr<R>& r) {
+        return { l.self(), r.self() };
+    }
+
+    template<typename L>
+    Node<Xor, L, Ref> operator^(const Expr<L>& l, const Binary& r) {
+        return { l.self(), Ref(r) };
+    }
+
+    template<typename R>
+    Node<Xor, Ref, R> operator^(const Binary& l, const Expr<R>& r) {
+        return { Ref(l), r.self() };
+    }
+}
+
+template<typename E>
+Binary& Binary::operator=(const lazy::Expr<E>& expr) {
+    const E& e = expr.self();
+    const std::size_t n = e.limbs();
+    LimbVector& limbs = lazy::Access::target(*this);
+    if (limbs.capacity() >= n) {
+        // growing w/in the capacity keeps the limbs in place, so `this` may be an operand
+        limbs.resize(std::max(limbs.size(), n), 0);
+        lazy::evaluate(limbs.data(), e, n);
+        limbs.resize(n);
+        lazy::Access::finish(*this, e.size());
+    } else {
+        LimbVector result(n);
+        lazy::evaluate(result.data(), e, n);
+        lazy::Access::assign(*this, std::move(result), e.size());
+    }
+    return *this;
+}
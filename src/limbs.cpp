@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <utility>
+#include "./limbs.hpp"
+#include "./arena.hpp"
+
+LimbVector::LimbVector() noexcept : m_data { m_inline }, m_size { 0 }, m_capacity { INLINE_LIMBS } {}
+
+LimbVector::LimbVector(std::size_t n, std::uint64_t value) : LimbVector() {
+    assign(n, value);
+}
+
+LimbVector::LimbVector(std::initializer_list<std::uint64_t> limbs) : LimbVector() {
+    reserve(limbs.size());
+    std::copy(limbs.begin(), limbs.end(), m_data);
+    m_size = limbs.size();
+}
+
+LimbVector::LimbVector(const LimbVector& other) : LimbVector() {
+    reserve(other.m_size);
+    std::copy(other.begin(), other.end(), m_data);
+    m_size = other.m_size;
+}
+
+LimbVector::LimbVector(LimbVector&& other) noexcept : LimbVector() {
+    *this = std::move(other);
+}
+
+LimbVector& LimbVector::operator=(const LimbVector& other) {
+    if (this != &other) {
+        m_size = 0;
+        reserve(other.m_size);
+        std::copy(other.begin(), other.end(), m_data);
+        m_size = other.m_size;
+    }
+    return *this;
+}
+
+LimbVector& LimbVector::operator=(LimbVector&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    if (other.is_inline()) {
+        // inline limbs cannot be stolen, but they always fit into `this`' storage
+        std::copy(other.begin(), other.end(), m_data);
+    } else {
+        if (!is_inline()) {
+            arena::deallocate(m_data);
+        }
+        m_data = other.m_data;
+        m_capacity = other.m_capacity;
+        other.m_data = other.m_inline;
+        other.m_capacity = INLINE_LIMBS;
+    }
+    m_size = other.m_size;
+    other.m_size = 0;
+    return *this;
+}
+
+LimbVector::~LimbVector() {
+    if (!is_inline()) {
+        arena::deallocate(m_data);
+    }
+}
+
+void LimbVector::reserve(std::size_t n) {
+    if (n > m_capacity) {
+        reallocate(n);
+    }
+}
+
+void LimbVector::resize(std::size_t n, std::uint64_t value) {
+    if (n > m_capacity) {
+        reallocate(std::max(n, 2 * m_capacity));
+    }
+    if (n > m_size) {
+        std::fill(m_data + m_size, m_data + n, value);
+    }
+    m_size = n;
+}
+
+void LimbVector::assign(std::size_t n, std::uint64_t value) {
+    m_size = 0;
+    reserve(n);
+    std::fill_n(m_data, n, value);
+    m_size = n;
+}
+
+void LimbVector::push_back(std::uint64_t limb) {
+    if (m_size == m_capacity) {
+        reallocate(2 * m_capacity);
+    }
+    m_data[m_size++] = limb;
+}
+
+bool LimbVector::operator==(const LimbVector& other) const {
+    return m_size == other.m_size && std::equal(begin(), end(), other.begin());
+}
+
+void LimbVector::reallocate(std::size_t capacity) {
+    std::uint64_t* data = static_cast<std::uint64_t*>(arena::allocate(capacity * sizeof(std::uint64_t)));
+    std::copy(begin(), end(), data);
+    if (!is_inline()) {
+        arena::deallocate(m_data);
+    }
+    m_data = data;
+    m_capacity = capacity;
+}
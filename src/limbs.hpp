@@ -0,0 +1,125 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+/**
+ * A growable array of limbs that keeps up to `INLINE_LIMBS` limbs inside the object itself
+ *
+ * Only numbers that outgrow the inline storage allocate their limbs on the heap, so short
+ * values can be created, copied and destroyed w/o any allocator traffic. The interface mirrors
+ * the subset of `std::vector<std::uint64_t>` that `Binary` relies on.
+ *
+ * Heap storage is obtained through `arena::allocate`, i.e. from the calling thread's arena if one
+ * is installed (see `arena.hpp`).
+ */
+class LimbVector {
+    public:
+    /** The number of limbs (256 bits) stored w/o heap allocation */
+    static constexpr std::size_t INLINE_LIMBS = 4;
+
+    /**
+     * Constructs an empty limb vector
+     */
+    LimbVector() noexcept;
+
+    /**
+     * Constructs a limb vector of `n` limbs
+     * @param n the number of limbs
+     * @param value the value of every limb
+     */
+    explicit LimbVector(std::size_t n, std::uint64_t value = 0);
+
+    /**
+     * Constructs a limb vector holding `limbs`
+     * @param limbs the limbs, least significant first
+     */
+    LimbVector(std::initializer_list<std::uint64_t> limbs);
+
+    LimbVector(const LimbVector& other);
+
+    /**
+     * Takes over `other`'s heap storage (if any), `other` is left empty
+     */
+    LimbVector(LimbVector&& other) noexcept;
+
+    LimbVector& operator=(const LimbVector& other);
+
+    LimbVector& operator=(LimbVector&& other) noexcept;
+
+    ~LimbVector();
+
+    std::size_t size() const { return m_size; }
+
+    bool empty() const { return !m_size; }
+
+    std::size_t capacity() const { return m_capacity; }
+
+    /**
+     * @returns whether the limbs are stored inside the object rather than on the heap
+     */
+    bool is_inline() const { return m_data == m_inline; }
+
+    std::uint64_t* data() { return m_data; }
+    const std::uint64_t* data() const { return m_data; }
+
+    std::uint64_t* begin() { return m_data; }
+    const std::uint64_t* begin() const { return m_data; }
+
+    std::uint64_t* end() { return m_data + m_size; }
+    const std::uint64_t* end() const { return m_data + m_size; }
+
+    std::uint64_t& operator[](std::size_t i) { return m_data[i]; }
+    const std::uint64_t& operator[](std::size_t i) const { return m_data[i]; }
+
+    std::uint64_t& back() { return m_data[m_size - 1]; }
+    const std::uint64_t& back() const { return m_data[m_size - 1]; }
+
+    /**
+     * Ensures room for at least `n` limbs w/o further reallocation
+     */
+    void reserve(std::size_t n);
+
+    /**
+     * Changes the number of limbs to `n`, new limbs are set to `value`
+     *
+     * Growing beyond the capacity at least doubles it, so repeated growth is amortized O(1) per limb.
+     */
+    void resize(std::size_t n, std::uint64_t value = 0);
+
+    /**
+     * Replaces the limbs by `n` limbs of `value`
+     */
+    void assign(std::size_t n, std::uint64_t value);
+
+    void push_back(std::uint64_t limb);
+
+    void pop_back() { --m_size; }
+
+    /**
+     * Removes all limbs, the capacity is kept
+     */
+    void clear() { m_size = 0; }
+
+    bool operator==(const LimbVector& other) const;
+
+    bool operator!=(const LimbVector& other) const { return !(*this == other); }
+
+    private:
+    /**
+     * Moves the limbs to a heap (or arena) array of `capacity` limbs
+     */
+    void reallocate(std::size_t capacity);
+
+    /** Points either to `m_inline` or to a heap array of `m_capacity` limbs */
+    std::uint64_t* m_data;
+
+    /** The number of limbs in use */
+    std::size_t m_size;
+
+    /** The number of limbs `m_data` has room for */
+    std::size_t m_capacity;
+
+    /** The inline storage used as long as `m_size` does not exceed `INLINE_LIMBS` */
+    std::uint64_t m_inline[INLINE_LIMBS];
+};
@@ -1,9 +1,14 @@
 #include <iostream>
+#include <fstream>
 #include <sstream>
 #include <vector>
 #include <iterator>
+#include <memory>
+#include "./arena.hpp"
 #include "./binary.hpp"
+#include "./parallel.hpp"
 #include "./parser.hpp"
+#include "./stream.hpp"
 
 /**
  * Prints a help description for the main routine to stdout
@@ -14,6 +19,21 @@ USAGE
         binary <expr>               evaluates and print <expr>
         binary <help|--help|-h>     shows this help
         binary -                    evaluates and prints expression read from stdin linewise
+        binary --save <file> <expr> evaluates <expr> and writes the resulting binary to the archive <file>
+        binary --stream <a> <op> <b> [<out>]
+                                    applies <op> to the archives <a> and <b> w/o loading them into memory,
+                                    where <op> is one of '&', '|', '^', '.' (writing the result to the
+                                    archive <out>) or '==', '!=', '<', '>' (printing the result)
+        binary --stream p <a>       prints the parity of the archive <a> w/o loading it into memory
+        binary --batch <expr>       compiles <expr> once and evaluates it for every line read from stdin,
+                                    where a line holds the values of the variables in <expr> as space
+                                    seperated literals, in the order the variables first occur in <expr>
+
+OPTIONS
+        --format <bin|oct|hex>      prints binary terms in the given radix instead of binary, octal
+                                    and hexadecimal digits are prefixed w/ '0o' and '0x'
+        --threads <n>               splits operations on large binaries across <n> threads (default: one
+                                    per core, at most four per core, '1' disables splitting)
 
 OUTPUT
         If the expression evaluates to a binary term the output consists of the binary
@@ -46,14 +66,23 @@ EXAMPLE
         >>> binary "(p (101 . 010)) == (p (010 . 101))"
         true
 
+        >>> printf "101 11 1\n0xf 0xf 0d15\n" | binary --batch "(a & b) == c"
+        true
+        true
+
 EXPRESSION
         Expressions have to be of the following form may consist of binary literals and operators
         where the following operators are supported:
          - &    bitwise logic and
          - |    bitwise logic or
          - ^    bitwise logic xor
+         - +    addition
+         - -    subtraction
+         - *    multiplication
          - /    divition
          - .    concatenation
+         - <<   shift left
+         - >>   shift right
          - p    parity
          - ==   compariton of equality
          - !=   compariton of unequality
@@ -61,9 +90,13 @@ EXPRESSION
          - >    compariton of strict 'less than'
 
         Note that the last four operators work on two binary operands of same type, whereas the
-        first five operators are only defined on binary operands.
+        first eleven operators are only defined on binary operands.
         Also note that a division's remainder is not part of further computations, if the divion
         result is fed to another operation.
+        Literals are written in binary (e.g. '101' or '0b101') or, when prefixed with '0o', '0d'
+        or '0x', in octal, decimal or hexadecimal (e.g. '0o5', '0d5' or '0x5').
+        Expressions evaluated w/ '--batch' may contain variables, i.e. words of letters and
+        underscores other than 'p' (e.g. 'a' or 'mask'), which stand for binary operands.
     )EOF";
 
     std::cout << help << std::endl;
@@ -71,11 +104,14 @@ EXPRESSION
 
 /**
  * Evaluates a given expression and print its result to stdout
+ *
+ * The evaluation allocates on `arena`, which is reset afterwards.
  */
-static void eval(std::string& s) {
+static void eval(std::string& s, Arena& arena) {
+    Arena::Scope scope(arena);
     try {
-        auto t = evaluate(s);
-        std::cout << *t << std::endl;
+        const Token t = evaluate(s);
+        std::cout << t << '\n';
     } catch (std::invalid_argument& e) {
         std::cerr << e.what() << std::endl;
     } catch (std::domain_error& e) {
@@ -83,15 +119,142 @@ static void eval(std::string& s) {
     } catch (...) {
         std::cerr << "An unexpected error occured" << std::endl;
     }
+    arena.reset();
+}
+
+/**
+ * Evaluates a prepared expression for every line of operands read from stdin (see `Program`)
+ *
+ * @returns the exit code
+ */
+static int batch(const std::string& expr) {
+    std::unique_ptr<Program> program;
+    try {
+        program.reset(new Program(expr));
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    const std::size_t count = program->variables().size();
+
+    for (std::string line; std::getline(std::cin, line); ) {
+        try {
+            // the operands are bound in place, w/o splitting the line into strings first
+            std::size_t n = 0;
+            for (std::size_t i = line.find_first_not_of(" \t"); i != std::string::npos; n++) {
+                const std::size_t end = std::min(line.find_first_of(" \t", i), line.size());
+                if (n < count) {
+                    program->bind(n, literal(line.data() + i, end - i));
+                }
+                i = line.find_first_not_of(" \t", end);
+            }
+            if (n != count) {
+                throw std::invalid_argument("Expected " + std::to_string(count) + " operands, found " + std::to_string(n));
+            }
+            std::cout << program->run() << '\n';
+        } catch (std::exception& e) {
+            std::cerr << e.what() << std::endl;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Evaluates an expression and writes its result to an archive file
+ *
+ * @returns the exit code
+ */
+static int save(const std::string& path, const std::string& expr) {
+    try {
+        const Token t = evaluate(expr);
+        if (t.type() != Token::Type::Bin) {
+            std::cerr << "Only binary results can be saved" << std::endl;
+            return 1;
+        }
+        std::ofstream os(path, std::ios::binary | std::ios::trunc);
+        if (!os) {
+            std::cerr << "Cannot open '" << path << "'" << std::endl;
+            return 1;
+        }
+        t.bin().save(os);
+        return 0;
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+}
+
+/**
+ * Evaluates an operation on archive files out-of-core (see `stream.hpp`)
+ *
+ * @param args the operands and operator, w/o the leading '--stream'
+ * @returns the exit code
+ */
+static int stream_files(const std::vector<std::string>& args) {
+    try {
+        if (args.size() == 2 && args[0] == "p") {
+            // numbers are always written in base 10, like by `Token::print`
+            std::cout << std::to_string(stream::parity(args[1])) << '\n';
+            return 0;
+        } else if (args.size() == 3 && (args[1] == "==" || args[1] == "!=" || args[1] == "<" || args[1] == ">")) {
+            const int c = stream::compare(args[0], args[2]);
+            const bool result = args[1] == "==" ? c == 0 : args[1] == "!=" ? c != 0 : args[1] == "<" ? c < 0 : c > 0;
+            std::cout << (result ? "true" : "false") << '\n';
+            return 0;
+        } else if (args.size() == 4 && args[1] == ".") {
+            stream::concat(args[0], args[2], args[3]);
+            return 0;
+        } else if (args.size() == 4 && (args[1] == "&" || args[1] == "|" || args[1] == "^")) {
+            const stream::Bitwise op = args[1] == "&" ? stream::Bitwise::And : args[1] == "|" ? stream::Bitwise::Or : stream::Bitwise::Xor;
+            stream::apply(op, args[0], args[2], args[3]);
+            return 0;
+        }
+        std::cerr << "Invalid arguments for '--stream', see 'binary --help'" << std::endl;
+        return 1;
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
 }
 
 /**
  * Parses given arguments and evaluates expression from arguments or stdin
  */
 int main(int argc, char** argv) {
-    if (argc > 1) {
-        std::vector<std::string> args;
-        args.assign(argv + 1, argv + argc);
+    // results are written in large chunks, w/o syncing every write w/ C stdio
+    std::ios::sync_with_stdio(false);
+    std::vector<std::string> args;
+    args.assign(argv + 1, argv + argc);
+    while (args.size() > 1 && (args[0] == "--format" || args[0] == "--threads")) {
+        if (args[0] == "--threads") {
+            const std::string& n = args[1];
+            if (n.empty() || n.find_first_not_of("0123456789") != std::string::npos || n.size() > 6) {
+                std::cerr << "Invalid thread count '" << n << "'. Expected a number" << std::endl;
+                return 1;
+            }
+            parallel::set_threads(std::stoul(n));
+        } else if (args[1] == "hex") {
+            std::cout << std::hex << std::showbase;
+        } else if (args[1] == "oct") {
+            std::cout << std::oct << std::showbase;
+        } else if (args[1] != "bin") {
+            std::cerr << "Unknown output format '" << args[1] << "'. Expected 'bin', 'oct' or 'hex'" << std::endl;
+            return 1;
+        }
+        args.erase(args.begin(), args.begin() + 2);
+    }
+
+    if (!args.empty() && args[0] == "--stream") {
+        return stream_files(std::vector<std::string>(args.begin() + 1, args.end()));
+    } else if (args.size() > 1 && args[0] == "--batch") {
+        std::ostringstream oss;
+        std::copy(args.begin() + 1, args.end(), std::ostream_iterator<std::string>(oss,""));
+        return batch(oss.str());
+    } else if (args.size() > 2 && args[0] == "--save") {
+        std::ostringstream oss;
+        std::copy(args.begin() + 2, args.end(), std::ostream_iterator<std::string>(oss,""));
+        return save(args[1], oss.str());
+    } else if (!args.empty()) {
         std::ostringstream oss;
         std::copy(args.begin(), args.end(), std::ostream_iterator<std::string>(oss,""));
         std::string arg = oss.str();
@@ -99,12 +262,15 @@ int main(int argc, char** argv) {
         if (arg == "help" || arg == "--help" || arg == "-h") {
             print_help();
             return 0;
-        } else if (arg == "-") {
+        }
+        // every line is evaluated on the same arena, so that its blocks are reused
+        Arena arena;
+        if (arg == "-") {
             for (std::string line; std::getline(std::cin, line); ) {
-                eval(line);
+                eval(line, arena);
             }
         } else {
-            eval(arg);
+            eval(arg, arena);
         }
     } else {
         print_help();
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "./parallel.hpp"
+
+std::size_t parallel::threshold = std::size_t { 1 } << 16;
+
+// a product of 1000 limbs takes about 400us on x86-64, which outweighs waking the workers by far
+std::size_t parallel::mul_threshold = 1000;
+
+std::size_t parallel::chunk_limbs = std::size_t { 1 } << 13;
+
+/** Whether the current thread runs tasks of the pool, i.e. is a worker or has submitted a batch */
+static thread_local bool in_pool = false;
+
+/**
+ * A fixed set of worker threads that run one batch of tasks at a time
+ */
+class Pool {
+    public:
+    /**
+     * Starts `threads - 1` workers, the thread submitting a batch is the last one
+     *
+     * If the system runs out of threads (or memory for them) the pool keeps the workers started
+     * so far, batches are then split across fewer threads.
+     */
+    explicit Pool(std::size_t threads)
+        : m_requested { threads }
+        , m_task { nullptr }
+        , m_tasks { 0 }
+        , m_next { 0 }
+        , m_generation { 0 }
+        , m_running { 0 }
+        , m_stop { false }
+    {
+        try {
+            m_workers.reserve(threads - 1);
+            for (std::size_t i = 1; i < threads; i++) {
+                m_workers.emplace_back([this]() { work(); });
+            }
+        } catch (const std::system_error&) {
+            // continue w/ the workers started so far
+        } catch (const std::bad_alloc&) {
+            // continue w/ the workers started so far
+        }
+    }
+
+    ~Pool() {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (std::thread& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    std::size_t threads() const { return m_workers.size() + 1; }
+
+    /**
+     * @returns the number of threads the pool was created for, which `threads` may fall short of
+     */
+    std::size_t requested() const { return m_requested; }
+
+    /**
+     * Runs `task(i)` for all `i` in `[0, n)` and waits for all of them to finish
+     */
+    void run(std::size_t n, const std::function<void(std::size_t)>& task) {
+        std::lock_guard<std::mutex> batch(m_batch);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_task = &task;
+            m_tasks = n;
+            m_next = 0;
+            m_running = m_workers.size();
+            m_generation++;
+        }
+        m_wake.notify_all();
+        in_pool = true;
+        drain();
+        in_pool = false;
+
+        // every worker has to report back before the task may go out of scope
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_done.wait(lock, [this]() { return m_running == 0; });
+        m_task = nullptr;
+    }
+
+    private:
+    /**
+     * Runs tasks of the current batch until none are left
+     */
+    void drain() {
+        for (std::size_t i; (i = m_next.fetch_add(1)) < m_tasks; ) {
+            (*m_task)(i);
+        }
+    }
+
+    void work() {
+        in_pool = true;
+        std::size_t seen = 0;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (;;) {
+            m_wake.wait(lock, [&]() { return m_stop || m_generation != seen; });
+            if (m_stop) {
+                return;
+            }
+            seen = m_generation;
+            lock.unlock();
+            drain();
+            lock.lock();
+            if (--m_running == 0) {
+                m_done.notify_one();
+            }
+        }
+    }
+
+    const std::size_t m_requested;
+
+    std::vector<std::thread> m_workers;
+
+    /** Serializes batches of concurrent callers */
+    std::mutex m_batch;
+
+    /** Guards the batch's fields and the worker accounting */
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+
+    const std::function<void(std::size_t)>* m_task;
+    std::size_t m_tasks;
+    std::atomic<std::size_t> m_next;
+
+    /** Counts the batches, so that workers can tell a new batch from a spurious wakeup */
+    std::size_t m_generation;
+
+    /** The number of workers that have not finished the current batch yet */
+    std::size_t m_running;
+
+    bool m_stop;
+};
+
+/**
+ * @returns one thread per core
+ */
+static std::size_t default_threads() {
+    const unsigned int cores = std::thread::hardware_concurrency();
+    return cores ? cores : 1;
+}
+
+/** The configured number of threads */
+static std::size_t configured = default_threads();
+
+/**
+ * @returns the pool, (re)started w/ the configured number of threads on first use after a change
+ */
+static Pool& pool() {
+    static std::mutex mutex;
+    static std::unique_ptr<Pool> instance;
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!instance || instance->requested() != configured) {
+        instance.reset();
+        instance.reset(new Pool(configured));
+    }
+    return *instance;
+}
+
+std::size_t parallel::threads() {
+    return configured;
+}
+
+std::size_t parallel::max_threads() {
+    return 4 * default_threads();
+}
+
+void parallel::set_threads(std::size_t n) {
+    configured = std::min(n ? n : default_threads(), max_threads());
+}
+
+bool parallel::available() {
+    return configured > 1 && !in_pool;
+}
+
+bool parallel::worthwhile(std::size_t n) {
+    return n >= threshold && available();
+}
+
+void parallel::for_each(std::size_t n, const std::function<void(std::size_t)>& task) {
+    if (n < 2 || !available()) {
+        for (std::size_t i = 0; i < n; i++) {
+            task(i);
+        }
+        return;
+    }
+    pool().run(n, task);
+}
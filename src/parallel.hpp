@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+
+/**
+ * A shared thread pool splitting operations on large operands across cores
+ *
+ * Operations on at least `threshold` limbs are divided into chunks of `chunk_limbs` limbs, which
+ * the calling thread and the pool's workers then process concurrently. Smaller operations run on
+ * the calling thread only, as handing them to other threads costs more than it saves.
+ *
+ * Multiplication (and thereby division) splits into independent sub-products instead, which are
+ * run as tasks of the pool. Tasks never split any further, a nested split runs on the thread
+ * running the task.
+ */
+namespace parallel {
+
+    /**
+     * The minimum number of limbs an operation must have to be split, may be tuned at runtime
+     */
+    extern std::size_t threshold;
+
+    /**
+     * The minimum number of limbs multiplication operands must have to split the sub-products, which
+     * is far lower than `threshold` as the work per limb grows w/ the operand size, may be tuned at
+     * runtime
+     */
+    extern std::size_t mul_threshold;
+
+    /**
+     * The number of limbs per chunk, sized so that a chunk of every operand fits into the L2 cache
+     */
+    extern std::size_t chunk_limbs;
+
+    /**
+     * @returns the number of threads operations are split across (including the calling thread)
+     */
+    std::size_t threads();
+
+    /**
+     * @returns the maximum number of threads, four per core
+     */
+    std::size_t max_threads();
+
+    /**
+     * Sets the number of threads operations are split across
+     *
+     * Must not be called while operations are running. If the system cannot start as many threads,
+     * the work is split across the threads that could be started.
+     *
+     * @param n the number of threads, `1` disables splitting, `0` uses one thread per core, counts
+     * beyond `max_threads` are capped
+     */
+    void set_threads(std::size_t n);
+
+    /**
+     * @returns whether work can be split, i.e. if more than one thread is configured and the caller
+     * is not running a task of the pool itself (nested splits run on the calling thread)
+     */
+    bool available();
+
+    /**
+     * @returns whether an operation on `n` limbs should be split, i.e. if `n` reaches `threshold`
+     * and splitting is `available`
+     */
+    bool worthwhile(std::size_t n);
+
+    /**
+     * Calls `task(i)` for every `i` in `[0, n)`, spread across the pool
+     *
+     * The indices are handed out in ascending order, the calling thread takes part in the work and
+     * the call returns once every task has finished. Only one such call runs at a time, concurrent
+     * callers are queued.
+     *
+     * @param n the number of tasks
+     * @param task the task to run, must not throw
+     */
+    void for_each(std::size_t n, const std::function<void(std::size_t)>& task);
+}
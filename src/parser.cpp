@@ -1,197 +1,289 @@
 #include <cassert>
+#include <cctype>
 #include <vector>
-#include <deque>
 #include <sstream>
 #include <algorithm>
 #include <stdexcept>
 #include <tuple>
+#include <limits>
+#include <utility>
 #include "./binary.hpp"
 #include "./parser.hpp"
+#include "./arena.hpp"
 
-#define METHOD_NOT_IMPLEMENTED assert(false && "Method not implemented")
-
-
-/*--------------------*
- *         Op         *
- *--------------------*/
-
-unsigned int precedence(Op op) {
-    switch (op) {
-        case Op::Parity:
-            return 4;
-
-        case Op::And:
-        case Op::Or:
-        case Op::Xor:
-        case Op::Concat:
-        case Op::Div:
-            return 3;
-
-        case Op::EQ:
-        case Op::NEQ:
-        case Op::GT:
-        case Op::LT:
-            return 2;
-
-        case Op::LPar:
-        case Op::RPar:
-            return 0;
-    }
-}
 
 /*--------------------*
  *       Token        *
  *--------------------*/
 
-Token::Token(Token::Type t) : type { t } {}
-
-Op Token::op() const { METHOD_NOT_IMPLEMENTED; return {}; }
+Token::Token(Op op) noexcept : m_type { Type::Op }, m_pair { false }, m_op { op } {}
 
-Binary Token::bin() const { METHOD_NOT_IMPLEMENTED; return {}; }
+Token::Token(Binary bin) noexcept : m_type { Type::Bin }, m_pair { false } {
+    new (&m_bins[0]) Binary(std::move(bin));
+}
 
-Binary Token::bin2() const { METHOD_NOT_IMPLEMENTED; return {}; }
+Token::Token(Binary quotient, Binary remainder) noexcept : m_type { Type::Bin }, m_pair { true } {
+    new (&m_bins[0]) Binary(std::move(quotient));
+    new (&m_bins[1]) Binary(std::move(remainder));
+}
 
-long Token::num() const { METHOD_NOT_IMPLEMENTED; return {}; }
+Token::Token(long n) noexcept : m_type { Type::Num }, m_pair { false }, m_n { n } {}
 
-bool Token::boolean() const { METHOD_NOT_IMPLEMENTED; return {}; }
+Token::Token(bool b) noexcept : m_type { Type::Bool }, m_pair { false }, m_b { b } {}
 
-std::string Token::to_str() const { METHOD_NOT_IMPLEMENTED; return {}; }
+Token Token::variable(std::size_t index) noexcept {
+    Token t(0L);
+    t.m_type = Type::Var;
+    t.m_var = index;
+    return t;
+}
 
-std::string Token::typeName() const {
-        switch (type) {
-            case Type::Op:
-                return "Operator";
-            case Type::Bin:
-                return "Binary";
-            case Type::Num:
-                return "Number";
-            case Type::Bool:
-                return "Bool";
-        }
-    };
+Token::Token(const Token& other) {
+    construct(other);
+}
 
-std::ostream& operator<<(std::ostream& os, Token& t) {
-    os << t.to_str();
-    return os;
+Token::Token(Token&& other) noexcept {
+    construct(std::move(other));
 }
 
-/* OpToken */
+Token& Token::operator=(const Token& other) {
+    if (this != &other) {
+        Token copy(other);
+        destroy();
+        construct(std::move(copy));
+    }
+    return *this;
+}
 
-OpToken::OpToken(Op op) : Token(Type::Op), m_op { op } {}
+Token& Token::operator=(Token&& other) noexcept {
+    if (this != &other) {
+        destroy();
+        construct(std::move(other));
+    }
+    return *this;
+}
 
-Op OpToken::op() const {
-    return m_op;
+Token::~Token() {
+    destroy();
 }
 
-/* BinToken */
+void Token::construct(const Token& other) {
+    m_type = other.m_type;
+    m_pair = other.m_pair;
+    switch (m_type) {
+        case Type::Op:
+            m_op = other.m_op;
+            break;
+        case Type::Bin:
+            new (&m_bins[0]) Binary(other.m_bins[0]);
+            if (m_pair) {
+                try {
+                    new (&m_bins[1]) Binary(other.m_bins[1]);
+                } catch (...) {
+                    m_bins[0].~Binary();
+                    throw;
+                }
+            }
+            break;
+        case Type::Num:
+            m_n = other.m_n;
+            break;
+        case Type::Bool:
+            m_b = other.m_b;
+            break;
+        case Type::Var:
+            m_var = other.m_var;
+            break;
+    }
+}
 
-BinToken::BinToken(Binary bin) : Token(Type::Bin), m_bin { bin } {}
+void Token::construct(Token&& other) noexcept {
+    m_type = other.m_type;
+    m_pair = other.m_pair;
+    switch (m_type) {
+        case Type::Op:
+            m_op = other.m_op;
+            break;
+        case Type::Bin:
+            new (&m_bins[0]) Binary(std::move(other.m_bins[0]));
+            if (m_pair) {
+                new (&m_bins[1]) Binary(std::move(other.m_bins[1]));
+            }
+            break;
+        case Type::Num:
+            m_n = other.m_n;
+            break;
+        case Type::Bool:
+            m_b = other.m_b;
+            break;
+        case Type::Var:
+            m_var = other.m_var;
+            break;
+    }
+}
 
-Binary BinToken::bin() const {
-    return m_bin;
+void Token::destroy() noexcept {
+    if (m_type == Type::Bin) {
+        m_bins[0].~Binary();
+        if (m_pair) {
+            m_bins[1].~Binary();
+        }
+    }
 }
 
-std::string BinToken::to_str() const {
-    std::stringstream ss;
-    ss << bin() << " " << bin().to_l();
-    return ss.str();
+Op Token::op() const {
+    assert(m_type == Type::Op);
+    return m_op;
 }
 
-/* Bin2Token */
+const Binary& Token::bin() const & {
+    assert(m_type == Type::Bin);
+    return m_bins[0];
+}
 
-Bin2Token::Bin2Token(Binary b1, Binary b2) : Token(Type::Bin)
-    , m_bin1 { b1 }
-    , m_bin2 { b2 }
-    {}
+Binary Token::bin() && {
+    assert(m_type == Type::Bin);
+    return std::move(m_bins[0]);
+}
 
-Binary Bin2Token::bin() const {
-    return m_bin1;
+const Binary& Token::bin2() const {
+    assert(has_bin2());
+    return m_bins[1];
 }
 
-Binary Bin2Token::bin2() const {
-    return m_bin2;
+long Token::num() const {
+    assert(m_type == Type::Num);
+    return m_n;
 }
 
-std::string Bin2Token::to_str() const {
-    std::stringstream ss;
-    ss << bin() << " R" << bin2() << " " << bin().to_l() << " R" << bin2().to_l();
-    return ss.str();
+bool Token::boolean() const {
+    assert(m_type == Type::Bool);
+    return m_b;
 }
 
-/* NumToken */
+std::size_t Token::var() const {
+    assert(m_type == Type::Var);
+    return m_var;
+}
 
-NumToken::NumToken(long l) : Token(Type::Num), m_n { l } {}
+std::string Token::typeName() const {
+    return typeName(m_type);
+}
 
-long NumToken::num() const {
-    return m_n;
+std::string Token::typeName(Type type) {
+    switch (type) {
+        case Type::Op:
+            return "Operator";
+        case Type::Bin:
+            return "Binary";
+        case Type::Num:
+            return "Number";
+        case Type::Bool:
+            return "Bool";
+        case Type::Var:
+            return "Variable";
+    }
+    return {};
 }
 
-std::string NumToken::to_str() const {
+std::string Token::to_str() const {
     std::stringstream ss;
-    ss << num();
+    print(ss);
     return ss.str();
 }
 
-/* BoolToken */
-
-BoolToken::BoolToken(bool b) : Token(Type::Bool), m_b { b } {}
-
-bool BoolToken::boolean() const {
-    return m_b;
+void Token::print(std::ostream& os) const {
+    switch (m_type) {
+        case Type::Op:
+        case Type::Var:
+            os << typeName();
+            break;
+        case Type::Bin:
+            if (m_pair) {
+                os << m_bins[0] << " R" << m_bins[1] << ' ' << m_bins[0].to_dec() << " R" << m_bins[1].to_dec();
+            } else {
+                os << m_bins[0] << ' ' << m_bins[0].to_dec();
+            }
+            break;
+        case Type::Num:
+            // numbers are always written in base 10, regardless of the stream's format flags
+            os << std::to_string(m_n);
+            break;
+        case Type::Bool:
+            os << (m_b ? "true" : "false");
+            break;
+    }
 }
 
-std::string BoolToken::to_str() const {
-    return boolean() ? "true" : "false";
+std::ostream& operator<<(std::ostream& os, const Token& t) {
+    t.print(os);
+    return os;
 }
 
 /*--------------------*
  *       Parser       *
  *--------------------*/
 
+/**
+ * Tokens and scratch containers of an evaluation are allocated through `arena::Allocator`, so that
+ * they are taken from the caller's arena if one is installed (see `arena.hpp`)
+ */
+using Tokens = std::vector<Token, arena::Allocator<Token> >;
+
 /**
  * Evaluates a vector of tokens that are formed in
  * <a href="https://en.wikipedia.org/wiki/Reverse_Polish_notation">RPN</a>
+ *
+ * The tokens' values are moved out of `expr`.
+ *
  * @param expr the expression to evaluate
  */
-static std::shared_ptr<Token> evaluate(std::vector<std::shared_ptr<Token> >& expr);
+static Token evaluate(Tokens& expr);
 
 /**
  * Parses an expression to a vector of tokens
  *
  * @param expr the expression to parse
+ * @param variables receives the names of variables, which are only accepted if it is given
  * @throws if the expression is misformed in terms of syntax
  */
-static std::vector<std::shared_ptr<Token> > tokenize(const std::string& expr);
+static Tokens tokenize(const std::string& expr, std::vector<std::string>* variables = nullptr);
 
-std::shared_ptr<Token> evaluate(const std::string& s) {
-    std::vector<std::shared_ptr<Token> > input = tokenize(s);
-    std::vector<Op> operators;
-    std::vector<std::shared_ptr<Token> > output;
+/**
+ * Reorders tokens from infix notation to RPN, the tokens' values are moved out of `input`
+ *
+ * @param input the tokens in infix notation
+ * @throws if the parentheses do not match
+ */
+static Tokens to_rpn(Tokens& input) {
+    std::vector<Op, arena::Allocator<Op> > operators;
+    Tokens output;
+    output.reserve(input.size());
 
     // build RPN stack by using shunting yard algorithm
     // see http://mathcenter.oxford.emory.edu/site/cs171/shuntingYardAlgorithm/
-    for (auto &t : input) {
-        if (t->type == Token::Type::Bin) {
-            output.push_back(t);
-        } else if (t->op() == Op::LPar) {
-            operators.push_back(t->op());
-        } else if (t->op() == Op::RPar) {
-            while (operators.back() != Op::LPar) {
+    for (Token& t : input) {
+        if (t.type() != Token::Type::Op) {
+            output.push_back(std::move(t));
+        } else if (t.op() == Op::LPar) {
+            operators.push_back(t.op());
+        } else if (t.op() == Op::RPar) {
+            while (operators.empty() || operators.back() != Op::LPar) {
                 if (operators.empty()) {
                     throw std::invalid_argument("Bad expression. Found ')' wihtout matching '('");
                 }
-                output.push_back(std::make_shared<OpToken>(OpToken(operators.back())));
+                output.emplace_back(operators.back());
                 operators.pop_back();
             }
             operators.pop_back(); // pop '('
-        } else if (operators.empty() || precedence(t->op()) > precedence(operators.back())) {
-            operators.push_back(t->op());
-        } else if (precedence(t->op()) <= precedence(operators.back())) {
+        } else if (operators.empty() || precedence(t.op()) > precedence(operators.back())) {
+            operators.push_back(t.op());
+        } else if (precedence(t.op()) <= precedence(operators.back())) {
             do {
-                output.push_back(std::make_shared<OpToken>(OpToken(operators.back())));
+                output.emplace_back(operators.back());
                 operators.pop_back();
-            } while (!operators.empty() && precedence(t->op()) <= precedence(operators.back()));
-            operators.push_back(t->op());
+            } while (!operators.empty() && precedence(t.op()) <= precedence(operators.back()));
+            operators.push_back(t.op());
         }
     }
 
@@ -200,147 +292,176 @@ std::shared_ptr<Token> evaluate(const std::string& s) {
         if (op == Op::LPar) {
             throw std::invalid_argument("Bad expression. Found '(' wihtout matching ')'");
         }
-        output.push_back(std::make_shared<OpToken>(OpToken(op)));
+        output.emplace_back(op);
         operators.pop_back();
     }
 
+    return output;
+}
+
+Token evaluate(const std::string& s) {
+    Tokens input = tokenize(s);
+    Tokens output = to_rpn(input);
+
     //evaluate RPN expression
     return evaluate(output);
 }
 
-std::shared_ptr<Token> evaluate(std::vector<std::shared_ptr<Token> >& expr) {
+/**
+ * @returns the symbol an operator is written as in error messages
+ */
+static const char* symbol(Op op) {
+    switch (op) {
+        case Op::GT: return ">";
+        case Op::LT: return "<";
+        case Op::EQ: return "==";
+        case Op::NEQ: return "!=";
+        case Op::And: return "&";
+        case Op::Or: return "|";
+        case Op::Xor: return "^";
+        case Op::Concat: return "concat";
+        case Op::Div: return "/";
+        case Op::Add: return "+";
+        case Op::Sub: return "-";
+        case Op::Mul: return "*";
+        case Op::Shl: return "<<";
+        case Op::Shr: return ">>";
+        case Op::Parity: return "p(arity)";
+        case Op::LPar: return "(";
+        case Op::RPar: return ")";
+    }
+    return "";
+}
+
+/**
+ * Checks that an operator has enough operands on a stack of `size` operands
+ * @throws std::invalid_argument if it has not
+ */
+static void check_arity(Op op, std::size_t size) {
+    if (size < (op == Op::Parity ? 1u : 2u)) {
+        throw std::invalid_argument("Operation '" + std::string(symbol(op)) + "' is applied to too few arguments");
+    }
+}
+
+/**
+ * Checks the operands' types of an operator, comparisons are defined on two operands of the same
+ * type, all other operators on binaries only
+ * @param op the operator
+ * @param lhs the left operand's type
+ * @param rhs the right operand's type, ignored for unary operators
+ * @throws std::invalid_argument if `op` is not defined on operands of these types
+ */
+static void check_types(Op op, Token::Type lhs, Token::Type rhs) {
+    if (op == Op::Parity) {
+        if (lhs != Token::Type::Bin) {
+            throw std::invalid_argument("Cannot perform 'p(arity)' on operand of type " + Token::typeName(lhs));
+        }
+        return;
+    }
+    const bool comparison = op == Op::EQ || op == Op::NEQ || op == Op::GT || op == Op::LT;
+    const bool ordered = op == Op::GT || op == Op::LT;
+    const bool valid = lhs == rhs && (lhs == Token::Type::Bin
+        || (comparison && lhs == Token::Type::Num)
+        || (comparison && !ordered && lhs == Token::Type::Bool));
+    if (!valid) {
+        throw std::invalid_argument("Cannot perform '" + std::string(symbol(op)) + "' on operands of type " + Token::typeName(lhs) + " and " + Token::typeName(rhs));
+    }
+}
+
+/**
+ * @returns a shift's amount as number of bits
+ * @throws std::invalid_argument if the amount exceeds the addressable bits
+ */
+static std::size_t shift_amount(Op op, const Binary& amount) {
+    if (amount > Binary(std::numeric_limits<std::size_t>::max())) {
+        throw std::invalid_argument("Cannot perform '" + std::string(symbol(op)) + "' by more bits than addressable");
+    }
+    return static_cast<std::size_t>(amount.to_l());
+}
+
+Token evaluate(Tokens& expr) {
     // s acts as stack during evaluation
-    // value tokens are pushed to the stack when read while
-    // operator tokens pop their arguments from the stack and
+    // value tokens are moved to the stack when read while
+    // operator tokens move their arguments off the stack and
     // push the operations result back to the stack
-    std::vector<std::shared_ptr<Token> > s;
+    Tokens s;
+    s.reserve(expr.size());
 
     // iterate through tokens of expr
-    for (auto t : expr) {
-        if (t->type == Token::Type::Bin) {
-            s.push_back(t);
-        } else if (t->type == Token::Type::Bool) {
-            s.push_back(t);
-        } else if (t->op() == Op::And) {
-            if (s.size() < 2) {
-                throw std::invalid_argument("Operation '&' is applied to too few arguments");
-            }
-            auto operand1 = s.back(); s.pop_back();
-            auto operand2 = s.back(); s.pop_back();
-            if (operand1->type != Token::Type::Bin || operand2->type != Token::Type::Bin) {
-                throw std::invalid_argument("Cannot perform '&' on operands of type " + operand2->typeName() + " and " + operand1->typeName());
-            }
-            s.push_back(std::make_shared<BinToken>(BinToken(operand1->bin() & operand2->bin())));
-        } else if (t->op() == Op::Or) {
-            if (s.size() < 2) {
-                throw std::invalid_argument("Operation '&' is applied to too few arguments");
-            }
-            auto operand1 = s.back(); s.pop_back();
-            auto operand2 = s.back(); s.pop_back();
-            if (operand1->type != Token::Type::Bin || operand2->type != Token::Type::Bin) {
-                throw std::invalid_argument("Cannot perform '|' on operands of type " + operand2->typeName() + " and " + operand1->typeName());
-            }
-            s.push_back(std::make_shared<BinToken>(BinToken(operand1->bin() | operand2->bin())));
-        } else if (t->op() == Op::Xor) {
-            if (s.size() < 2) {
-                throw std::invalid_argument("Operation '&' is applied to too few arguments");
-            }
-            auto operand1 = s.back(); s.pop_back();
-            auto operand2 = s.back(); s.pop_back();
-            if (operand1->type != Token::Type::Bin || operand2->type != Token::Type::Bin) {
-                throw std::invalid_argument("Cannot perform '^' on operands of type " + operand2->typeName() + " and " + operand1->typeName());
-            }
-            s.push_back(std::make_shared<BinToken>(BinToken(operand1->bin() ^ operand2->bin())));
-        } else if (t->op() == Op::Div) {
-            if (s.size() < 2) {
-                throw std::invalid_argument("Operation '/' is applied to too few arguments");
-            }
-            auto operand2 = s.back(); s.pop_back();
-            auto operand1 = s.back(); s.pop_back();
-            if (operand1->type != Token::Type::Bin || operand2->type != Token::Type::Bin) {
-                throw std::invalid_argument("Cannot perform '/' on operands of type " + operand2->typeName() + " and " + operand1->typeName());
-            }
-            auto result = operand1->bin().div(operand2->bin());
-            s.push_back(std::make_shared<Bin2Token>(Bin2Token(std::get<0>(result), std::get<1>(result))));
-        } else if (t->op() == Op::Concat) {
-            if (s.size() < 2) {
-                throw std::invalid_argument("Operation '&' is applied to too few arguments");
-            }
-            auto operand2 = s.back(); s.pop_back();
-            auto operand1 = s.back(); s.pop_back();
-            if (operand1->type != Token::Type::Bin || operand2->type != Token::Type::Bin) {
-                throw std::invalid_argument("Cannot perform 'concat' on operands of type " + operand1->typeName() + " and " + operand2->typeName());
-            }
-            s.push_back(std::make_shared<BinToken>(BinToken(operand1->bin().concat(operand2->bin()))));
-        } else if (t->op() == Op::EQ) {
-            if (s.size() < 2) {
-                throw std::invalid_argument("Operation '&' is applied to too few arguments");
-            }
-            auto operand2 = s.back(); s.pop_back();
-            auto operand1 = s.back(); s.pop_back();
-            if (operand1->type == Token::Type::Bin && operand2->type == Token::Type::Bin) {
-                s.push_back(std::make_shared<BoolToken>(BoolToken(operand1->bin() == operand2->bin())));
-            } else if (operand1->type == Token::Type::Num && operand2->type == Token::Type::Num) {
-                s.push_back(std::make_shared<BoolToken>(BoolToken(operand1->num() == operand2->num())));
-            } else if (operand1->type == Token::Type::Bool && operand2->type == Token::Type::Bool) {
-                s.push_back(std::make_shared<BoolToken>(BoolToken(operand1->boolean() == operand2->boolean())));
-            } else {
-                throw std::invalid_argument("Cannot perform '==' on operands of type " + operand1->typeName() + " and " + operand2->typeName());
-            }
-        } else if (t->op() == Op::NEQ) {
-            if (s.size() < 2) {
-                throw std::invalid_argument("Operation '&' is applied to too few arguments");
-            }
-            auto operand2 = s.back(); s.pop_back();
-            auto operand1 = s.back(); s.pop_back();
-            if (operand1->type == Token::Type::Bin && operand2->type == Token::Type::Bin) {
-                s.push_back(std::make_shared<BoolToken>(BoolToken(operand1->bin() != operand2->bin())));
-            } else if (operand1->type == Token::Type::Num && operand2->type == Token::Type::Num) {
-                s.push_back(std::make_shared<BoolToken>(BoolToken(operand1->num() != operand2->num())));
-            } else if (operand1->type == Token::Type::Bool && operand2->type == Token::Type::Bool) {
-                s.push_back(std::make_shared<BoolToken>(BoolToken(operand1->boolean() != operand2->boolean())));
-            } else {
-                throw std::invalid_argument("Cannot perform '!=' on operands of type " + operand1->typeName() + " and " + operand2->typeName());
-            }
-        } else if (t->op() == Op::GT) {
-            if (s.size() < 2) {
-                throw std::invalid_argument("Operation '&' is applied to too few arguments");
-            }
-            auto operand2 = s.back(); s.pop_back();
-            auto operand1 = s.back(); s.pop_back();
-            if (operand1->type == Token::Type::Bin && operand2->type == Token::Type::Bin) {
-                s.push_back(std::make_shared<BoolToken>(BoolToken(operand1->bin() > operand2->bin())));
-            } else if (operand1->type == Token::Type::Num && operand2->type == Token::Type::Num) {
-                s.push_back(std::make_shared<BoolToken>(BoolToken(operand1->num() > operand2->num())));
-            } else {
-                throw std::invalid_argument("Cannot perform '>' on operands of type " + operand1->typeName() + " and " + operand2->typeName());
-            }
-        } else if (t->op() == Op::LT) {
-            if (s.size() < 2) {
-                throw std::invalid_argument("Operation '&' is applied to too few arguments");
-            }
-            auto operand2 = s.back(); s.pop_back();
-            auto operand1 = s.back(); s.pop_back();
-            if (operand1->type == Token::Type::Bin && operand2->type == Token::Type::Bin) {
-                s.push_back(std::make_shared<BoolToken>(BoolToken(operand1->bin() < operand2->bin())));
-            } else if (operand1->type == Token::Type::Num && operand2->type == Token::Type::Num) {
-                s.push_back(std::make_shared<BoolToken>(BoolToken(operand1->num() < operand2->num())));
-            } else {
-                throw std::invalid_argument("Cannot perform '<' on operands of type " + operand1->typeName() + " and " + operand2->typeName());
-            }
-        } else if (t->op() == Op::Parity) {
-            if (s.size() < 1) {
-                throw std::invalid_argument("Operation '&' is applied to too few arguments");
+    for (Token& t : expr) {
+        if (t.type() != Token::Type::Op) {
+            s.push_back(std::move(t));
+            continue;
+        }
+
+        const Op op = t.op();
+        check_arity(op, s.size());
+
+        if (op == Op::Parity) {
+            Token& operand = s.back();
+            check_types(op, operand.type(), operand.type());
+            operand = Token(operand.bin().parity());
+            continue;
+        }
+
+        // the result replaces the left operand, the right one is popped afterwards
+        Token& operand1 = s[s.size() - 2];
+        Token& operand2 = s.back();
+        check_types(op, operand1.type(), operand2.type());
+        const bool bins = operand1.type() == Token::Type::Bin;
+        const bool nums = operand1.type() == Token::Type::Num;
+
+        switch (op) {
+            case Op::And:
+                operand1 = Token(std::move(operand1).bin() & operand2.bin());
+                break;
+            case Op::Or:
+                operand1 = Token(std::move(operand1).bin() | operand2.bin());
+                break;
+            case Op::Xor:
+                operand1 = Token(std::move(operand1).bin() ^ operand2.bin());
+                break;
+            case Op::Add:
+                operand1 = Token(std::move(operand1).bin() + operand2.bin());
+                break;
+            case Op::Sub:
+                operand1 = Token(std::move(operand1).bin() - operand2.bin());
+                break;
+            case Op::Mul:
+                operand1 = Token(operand1.bin() * operand2.bin());
+                break;
+            case Op::Div: {
+                auto result = operand1.bin().div(operand2.bin());
+                operand1 = Token(std::move(std::get<0>(result)), std::move(std::get<1>(result)));
+                break;
             }
-            auto operand = s.back(); s.pop_back();
-            if (operand->type == Token::Type::Bin) {
-                s.push_back(std::make_shared<NumToken>(NumToken(operand->bin().parity())));
-            } else {
-                throw std::invalid_argument("Cannot perform 'p(arity)' on operand of type " + operand->typeName());
+            case Op::Concat:
+                operand1 = Token(std::move(operand1).bin().concat(operand2.bin()));
+                break;
+            case Op::Shl:
+            case Op::Shr: {
+                const std::size_t n = shift_amount(op, operand2.bin());
+                operand1 = Token(op == Op::Shl ? std::move(operand1).bin() << n : std::move(operand1).bin() >> n);
+                break;
             }
-        } else {
-            throw std::invalid_argument("Unknown token of type " + t->typeName());
+            case Op::EQ:
+                operand1 = Token(bins ? operand1.bin() == operand2.bin() : nums ? operand1.num() == operand2.num() : operand1.boolean() == operand2.boolean());
+                break;
+            case Op::NEQ:
+                operand1 = Token(bins ? operand1.bin() != operand2.bin() : nums ? operand1.num() != operand2.num() : operand1.boolean() != operand2.boolean());
+                break;
+            case Op::GT:
+                operand1 = Token(bins ? operand1.bin() > operand2.bin() : operand1.num() > operand2.num());
+                break;
+            case Op::LT:
+                operand1 = Token(bins ? operand1.bin() < operand2.bin() : operand1.num() < operand2.num());
+                break;
+            case Op::Parity:
+            case Op::LPar:
+            case Op::RPar:
+                throw std::invalid_argument("Unknown token of type " + t.typeName());
         }
+        s.pop_back();
     }
 
     // after successful evaluation the stack must contain a single value
@@ -348,107 +469,187 @@ std::shared_ptr<Token> evaluate(std::vector<std::shared_ptr<Token> >& expr) {
         throw std::invalid_argument("Expression cannot be evaluated to a single value");
     }
 
-    return s.front();
+    return std::move(s.front());
+}
+
+/**
+ * Parses the digits of a literal w/ radix prefix
+ * @param prefix the prefix' letter, i.e. 'b', 'o', 'd' or 'x'
+ * @param digits the digits following the prefix
+ * @param len the number of digits
+ */
+static Binary prefixed(char prefix, const char* digits, std::size_t len) {
+    return prefix == 'b' ? Binary(digits, len)
+        : prefix == 'o' ? Binary::from_oct(digits, len)
+        : prefix == 'd' ? Binary::from_dec(digits, len)
+        : Binary::from_hex(digits, len);
+}
+
+/**
+ * @returns whether `c` may be part of a variable's name
+ */
+static bool is_word(char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
 }
 
-std::vector<std::shared_ptr<Token> > tokenize(const std::string& s) {
-    // TODO: use string_iterator instead of deque?
-    std::deque<char> input(s.begin(), s.end());
-    std::vector<std::shared_ptr<Token> > output;
+Binary literal(const char* s, std::size_t n) {
+    if (n >= 2 && s[0] == '0' && std::string("bodx").find(s[1]) != std::string::npos) {
+        if (n == 2) {
+            throw std::invalid_argument("Expected digits after '" + std::string(s, 2) + "'");
+        }
+        return prefixed(s[1], s + 2, n - 2);
+    } else if (!n) {
+        throw std::invalid_argument("Expected a literal");
+    }
+    return Binary(s, n);
+}
 
-    std::string curr("");
+Tokens tokenize(const std::string& s, std::vector<std::string>* variables) {
+    Tokens output;
+    std::size_t i = 0;
+
+    // digits of the current literal, which may be interrupted by whitespace
+    std::basic_string<char, std::char_traits<char>, arena::Allocator<char> > curr;
 
     auto push_binary_token = [&]() {
         if (!curr.empty()) {
-            Binary b;
-            std::stringstream(curr) >> b;
+            output.emplace_back(Binary(curr.data(), curr.size()));
             curr.clear();
-            BinToken tok(b);
-            output.push_back(std::make_shared<BinToken>(tok));
         }
     };
 
     auto push_operator_token = [&](Op op) {
-        OpToken tok(op);
-        output.push_back(std::make_shared<OpToken>(tok));
+        output.emplace_back(op);
     };
 
-    while (input.size()) {
-        while (isspace(input.front())) {
-            input.pop_front();
+    while (i < s.size()) {
+        while (i < s.size() && isspace(s[i])) {
+            i++;
+        }
+        if (i == s.size()) {
+            break;
         }
-        
-        if (input.front() == '1' || input.front() == '0') {
-            curr.push_back(input.front());
-            input.pop_front();
-        } else if (input.front() == '&') {
+
+        if (s[i] == '0' && i + 1 < s.size() && std::string("bodx").find(s[i + 1]) != std::string::npos) {
+            // a literal w/ radix prefix, e.g. '0b101', '0o17', '0d42' or '0xff'
+            push_binary_token();
+            const char prefix = s[i + 1];
+            const char* digits = prefix == 'b' ? "01" : prefix == 'o' ? "01234567" : prefix == 'd' ? "0123456789" : "0123456789abcdefABCDEF";
+            const std::size_t start = i + 2;
+            const std::size_t end = std::min(s.find_first_not_of(digits, start), s.size());
+            if (end == start) {
+                throw std::invalid_argument("Expected digits after '0" + std::string(1, prefix) + "' at position " + std::to_string(i));
+            }
+            output.emplace_back(prefixed(prefix, s.data() + start, end - start));
+            i = end;
+        } else if (s[i] == '1' || s[i] == '0') {
+            // the whole run of digits is appended at once
+            const std::size_t end = s.find_first_not_of("01", i);
+            const std::size_t len = (end == std::string::npos ? s.size() : end) - i;
+            curr.append(s.data() + i, len);
+            i += len;
+        } else if (s[i] == '&') {
             push_binary_token();
             push_operator_token(Op::And);
-            input.pop_front();
-        } else if (input.front() == '|') {
+            i++;
+        } else if (s[i] == '|') {
             push_binary_token();
             push_operator_token(Op::Or);
-            input.pop_front();
-        } else if (input.front() == '^') {
+            i++;
+        } else if (s[i] == '^') {
             push_binary_token();
             push_operator_token(Op::Xor);
-            input.pop_front();
-        } else if (input.front() == '/') {
+            i++;
+        } else if (s[i] == '/') {
             push_binary_token();
             push_operator_token(Op::Div);
-            input.pop_front();
-        } else if (input.front() == '.') {
+            i++;
+        } else if (s[i] == '+') {
+            push_binary_token();
+            push_operator_token(Op::Add);
+            i++;
+        } else if (s[i] == '-') {
+            push_binary_token();
+            push_operator_token(Op::Sub);
+            i++;
+        } else if (s[i] == '*') {
+            push_binary_token();
+            push_operator_token(Op::Mul);
+            i++;
+        } else if (s[i] == '.') {
             push_binary_token();
             push_operator_token(Op::Concat);
-            input.pop_front();
-        } else if (input.front() == '>') {
+            i++;
+        } else if (s[i] == '>') {
             push_binary_token();
-            push_operator_token(Op::GT);
-            input.pop_front();
-        } else if (input.front() == '<') {
+            i++;
+            if (i < s.size() && s[i] == '>') {
+                push_operator_token(Op::Shr);
+                i++;
+            } else {
+                push_operator_token(Op::GT);
+            }
+        } else if (s[i] == '<') {
             push_binary_token();
-            push_operator_token(Op::LT);
-            input.pop_front();
-        } else if (input.front() == '=') {
-            if (input.size() < 2) {
+            i++;
+            if (i < s.size() && s[i] == '<') {
+                push_operator_token(Op::Shl);
+                i++;
+            } else {
+                push_operator_token(Op::LT);
+            }
+        } else if (s[i] == '=') {
+            if (i + 1 >= s.size()) {
                 throw std::invalid_argument("Unexpected end of input. Expected '='");
-            } else if (input.at(1) == '=') {
+            } else if (s[i + 1] == '=') {
                 push_binary_token();
                 push_operator_token(Op::EQ);
-                input.pop_front();
-                input.pop_front();
+                i += 2;
             } else {
-                throw std::invalid_argument("Invalid input character '" + std::string(1, input.front()) + "'. Expected '='");
+                throw std::invalid_argument("Invalid input character '" + std::string(1, s[i]) + "'. Expected '='");
             }
-        } else if (input.front() == '!') {
-            if (input.size() < 2) {
+        } else if (s[i] == '!') {
+            if (i + 1 >= s.size()) {
                 throw std::invalid_argument("Unexpected end of input. Expected '='");
-            } else if (input.at(1) == '=') {
+            } else if (s[i + 1] == '=') {
                 push_binary_token();
                 push_operator_token(Op::NEQ);
-                input.pop_front();
-                input.pop_front();
+                i += 2;
             } else {
-                throw std::invalid_argument("Invalid input character '" + std::string(1, input.front()) + "'. Expected '='");
+                throw std::invalid_argument("Invalid input character '" + std::string(1, s[i]) + "'. Expected '='");
+            }
+        } else if (variables && is_word(s[i]) && (s[i] != 'p' || (i + 1 < s.size() && is_word(s[i + 1])))) {
+            // a variable, i.e. any word but the parity operator
+            push_binary_token();
+            std::size_t end = i;
+            while (end < s.size() && is_word(s[end])) {
+                end++;
             }
-        } else if (input.front() == 'p') {
+            const std::string name = s.substr(i, end - i);
+            const std::size_t index = static_cast<std::size_t>(std::find(variables->begin(), variables->end(), name) - variables->begin());
+            if (index == variables->size()) {
+                variables->push_back(name);
+            }
+            output.push_back(Token::variable(index));
+            i = end;
+        } else if (s[i] == 'p') {
             push_binary_token();
             push_operator_token(Op::Parity);
-            input.pop_front();
-        } else if (input.front() == '(') {
+            i++;
+        } else if (s[i] == '(') {
             push_binary_token();
             push_operator_token(Op::LPar);
-            input.pop_front();
-        } else if (input.front() == ')') {
+            i++;
+        } else if (s[i] == ')') {
             push_binary_token();
             push_operator_token(Op::RPar);
-            input.pop_front();
+            i++;
         } else {
-            throw std::invalid_argument("Invalid input character '" + std::string(1, input.front()) + "'");
+            throw std::invalid_argument("Invalid input character '" + std::string(1, s[i]) + "' at position " + std::to_string(i));
         }
 
-        while (isspace(input.front())) {
-            input.pop_front();
+        while (i < s.size() && isspace(s[i])) {
+            i++;
         }
     }
 
@@ -457,3 +658,238 @@ std::vector<std::shared_ptr<Token> > tokenize(const std::string& s) {
     return output;
 }
 
+
+/*--------------------*
+ *      Program       *
+ *--------------------*/
+
+/**
+ * @returns the index of a type's operand stack
+ */
+static std::size_t stack_of(Token::Type type) {
+    return type == Token::Type::Bin ? 0 : type == Token::Type::Num ? 1 : 2;
+}
+
+Program::Program(const std::string& expr) : m_result { Token::Type::Bin } {
+    Tokens input = tokenize(expr, &m_names);
+    Tokens rpn = to_rpn(input);
+    m_values.resize(m_names.size());
+    m_bound.assign(m_names.size(), 0);
+
+    // the operands' types are tracked on a stack while the instructions are emitted, along w/ the
+    // depth every operand stack reaches
+    std::vector<Token::Type> types;
+    std::size_t depth[3] = { 0, 0, 0 }, deepest[3] = { 0, 0, 0 };
+    auto push = [&](Token::Type type) {
+        types.push_back(type);
+        const std::size_t i = stack_of(type);
+        deepest[i] = std::max(deepest[i], ++depth[i]);
+    };
+    auto pop = [&]() {
+        depth[stack_of(types.back())]--;
+        types.pop_back();
+    };
+    auto emit = [&](Code code, std::size_t arg) {
+        m_code.push_back({ code, static_cast<std::uint32_t>(arg) });
+    };
+
+    for (Token& t : rpn) {
+        if (t.type() == Token::Type::Bin) {
+            emit(Code::Literal, m_literals.size());
+            m_literals.push_back(std::move(t).bin());
+            push(Token::Type::Bin);
+            continue;
+        } else if (t.type() == Token::Type::Var) {
+            emit(Code::Load, t.var());
+            push(Token::Type::Bin);
+            continue;
+        }
+
+        const Op op = t.op();
+        check_arity(op, types.size());
+        if (op == Op::Parity) {
+            check_types(op, types.back(), types.back());
+            pop();
+            emit(Code::Parity, 0);
+            push(Token::Type::Num);
+            continue;
+        }
+
+        const Token::Type type = types[types.size() - 2];
+        check_types(op, type, types.back());
+        pop();
+        pop();
+        const bool nums = type == Token::Type::Num, bools = type == Token::Type::Bool;
+        switch (op) {
+            case Op::And: emit(Code::And, 0); break;
+            case Op::Or: emit(Code::Or, 0); break;
+            case Op::Xor: emit(Code::Xor, 0); break;
+            case Op::Add: emit(Code::Add, 0); break;
+            case Op::Sub: emit(Code::Sub, 0); break;
+            case Op::Mul: emit(Code::Mul, 0); break;
+            case Op::Div: emit(Code::Div, 0); break;
+            case Op::Concat: emit(Code::Concat, 0); break;
+            case Op::Shl: emit(Code::Shl, 0); break;
+            case Op::Shr: emit(Code::Shr, 0); break;
+            case Op::EQ: emit(nums ? Code::EqNum : bools ? Code::EqBool : Code::EqBin, 0); break;
+            case Op::NEQ: emit(nums ? Code::NeqNum : bools ? Code::NeqBool : Code::NeqBin, 0); break;
+            case Op::GT: emit(nums ? Code::GtNum : Code::GtBin, 0); break;
+            case Op::LT: emit(nums ? Code::LtNum : Code::LtBin, 0); break;
+            case Op::Parity:
+            case Op::LPar:
+            case Op::RPar:
+                throw std::invalid_argument("Unknown token of type " + t.typeName());
+        }
+        const bool comparison = op == Op::EQ || op == Op::NEQ || op == Op::GT || op == Op::LT;
+        push(comparison ? Token::Type::Bool : Token::Type::Bin);
+    }
+
+    // after successful evaluation the stack must contain a single value
+    if (types.size() != 1) {
+        throw std::invalid_argument("Expression cannot be evaluated to a single value");
+    }
+    m_result = types.front();
+    if (m_code.back().code == Code::Div) {
+        // only the expression's value keeps the remainder of a division
+        m_code.back().code = Code::DivRem;
+    }
+
+    m_bins.resize(deepest[0]);
+    m_nums.resize(deepest[1]);
+    m_bools.resize(deepest[2]);
+}
+
+std::size_t Program::index(const std::string& name) const {
+    const auto found = std::find(m_names.begin(), m_names.end(), name);
+    if (found == m_names.end()) {
+        throw std::invalid_argument("Unknown variable '" + name + "'");
+    }
+    return static_cast<std::size_t>(found - m_names.begin());
+}
+
+void Program::bind(std::size_t index, const Binary& value) {
+    m_values[index] = value;
+    m_bound[index] = 1;
+}
+
+void Program::bind(std::size_t index, Binary&& value) {
+    m_values[index] = std::move(value);
+    m_bound[index] = 1;
+}
+
+Token Program::run() {
+    const auto unbound = std::find(m_bound.begin(), m_bound.end(), 0);
+    if (unbound != m_bound.end()) {
+        throw std::invalid_argument("Variable '" + m_names[static_cast<std::size_t>(unbound - m_bound.begin())] + "' is not bound");
+    }
+
+    // the depth of each operand stack, results overwrite their left operand in place so that the
+    // binaries' storage is reused from run to run
+    std::size_t bins = 0, nums = 0, bools = 0;
+    for (const Instruction& in : m_code) {
+        switch (in.code) {
+            case Code::Literal:
+                m_bins[bins++] = m_literals[in.arg];
+                break;
+            case Code::Load:
+                m_bins[bins++] = m_values[in.arg];
+                break;
+            case Code::And:
+                bins--;
+                m_bins[bins - 1] &= m_bins[bins];
+                break;
+            case Code::Or:
+                bins--;
+                m_bins[bins - 1] |= m_bins[bins];
+                break;
+            case Code::Xor:
+                bins--;
+                m_bins[bins - 1] ^= m_bins[bins];
+                break;
+            case Code::Add:
+                bins--;
+                m_bins[bins - 1] += m_bins[bins];
+                break;
+            case Code::Sub:
+                bins--;
+                m_bins[bins - 1] -= m_bins[bins];
+                break;
+            case Code::Mul:
+                bins--;
+                m_bins[bins - 1] *= m_bins[bins];
+                break;
+            case Code::Div:
+                bins--;
+                m_bins[bins - 1] = m_bins[bins - 1] / m_bins[bins];
+                break;
+            case Code::DivRem: {
+                auto result = m_bins[bins - 2].div(m_bins[bins - 1]);
+                return Token(std::move(std::get<0>(result)), std::move(std::get<1>(result)));
+            }
+            case Code::Concat:
+                bins--;
+                m_bins[bins - 1] = std::move(m_bins[bins - 1]).concat(m_bins[bins]);
+                break;
+            case Code::Shl:
+                bins--;
+                m_bins[bins - 1] <<= shift_amount(Op::Shl, m_bins[bins]);
+                break;
+            case Code::Shr:
+                bins--;
+                m_bins[bins - 1] >>= shift_amount(Op::Shr, m_bins[bins]);
+                break;
+            case Code::Parity:
+                m_nums[nums++] = m_bins[--bins].parity();
+                break;
+            case Code::EqBin:
+                bins -= 2;
+                m_bools[bools++] = m_bins[bins] == m_bins[bins + 1];
+                break;
+            case Code::NeqBin:
+                bins -= 2;
+                m_bools[bools++] = m_bins[bins] != m_bins[bins + 1];
+                break;
+            case Code::GtBin:
+                bins -= 2;
+                m_bools[bools++] = m_bins[bins] > m_bins[bins + 1];
+                break;
+            case Code::LtBin:
+                bins -= 2;
+                m_bools[bools++] = m_bins[bins] < m_bins[bins + 1];
+                break;
+            case Code::EqNum:
+                nums -= 2;
+                m_bools[bools++] = m_nums[nums] == m_nums[nums + 1];
+                break;
+            case Code::NeqNum:
+                nums -= 2;
+                m_bools[bools++] = m_nums[nums] != m_nums[nums + 1];
+                break;
+            case Code::GtNum:
+                nums -= 2;
+                m_bools[bools++] = m_nums[nums] > m_nums[nums + 1];
+                break;
+            case Code::LtNum:
+                nums -= 2;
+                m_bools[bools++] = m_nums[nums] < m_nums[nums + 1];
+                break;
+            case Code::EqBool:
+                bools--;
+                m_bools[bools - 1] = m_bools[bools - 1] == m_bools[bools];
+                break;
+            case Code::NeqBool:
+                bools--;
+                m_bools[bools - 1] = m_bools[bools - 1] != m_bools[bools];
+                break;
+        }
+    }
+
+    switch (m_result) {
+        case Token::Type::Num:
+            return Token(m_nums.front());
+        case Token::Type::Bool:
+            return Token(m_bools.front() != 0);
+        default:
+            return Token(m_bins.front());
+    }
+}
@@ -1,5 +1,8 @@
 #pragma once
-#include <memory>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
 #include "./binary.hpp"
 
 /**
@@ -25,6 +28,16 @@ enum class Op {
     Concat,
     /** Div '/' operator */
     Div,
+    /** Add '+' operator */
+    Add,
+    /** Sub '-' operator */
+    Sub,
+    /** Mul '*' operator */
+    Mul,
+    /** Shift left '<<' operator */
+    Shl,
+    /** Shift right '>>' operator */
+    Shr,
 
     /** Parity 'p' operator */
     Parity,
@@ -38,195 +51,334 @@ enum class Op {
 /**
  * @returns an operator's precedence
  */
-unsigned int precedence(Op op);
+constexpr unsigned int precedence(Op op) {
+    switch (op) {
+        case Op::Parity:
+            return 4;
+
+        case Op::And:
+        case Op::Or:
+        case Op::Xor:
+        case Op::Concat:
+        case Op::Div:
+        case Op::Add:
+        case Op::Sub:
+        case Op::Mul:
+        case Op::Shl:
+        case Op::Shr:
+            return 3;
+
+        case Op::EQ:
+        case Op::NEQ:
+        case Op::GT:
+        case Op::LT:
+            return 2;
+
+        case Op::LPar:
+        case Op::RPar:
+            return 0;
+    }
+    return 0;
+}
 
 
 /**
  * Represents a parsed / evaluated token value
  *
- * A token may hold a value which *must* be representable in at least one of the following forms:
- * - Operator
- * - Binary
- * - int
- * - bool
+ * A token holds exactly one of the following values
+ * - an operator (`Type::Op`)
+ * - a binary, or the quotient and remainder of a division (`Type::Bin`)
+ * - a number (`Type::Num`)
+ * - a bool (`Type::Bool`)
+ * - a reference to a variable of a prepared expression (`Type::Var`, see `Program`)
  *
- * The token's `type` indicates which representation will be guaranteed available, other
- * representations are possible but not guaranteed to succeed.
+ * Tokens are plain values, the value is stored in a tagged union inside the token itself, so that
+ * tokens can be kept contiguously in a vector and w/o any virtual dispatch. Accessing a value of
+ * another type than the token's `type` is a programming error.
  */
-struct Token {
-    /** A token's type
-     *
-     * Acts as a tag in the tagged union type `Token` with instances
-     * - `OpToken` (`Token::Type::Op`)
-     * - `BinToken` (`Token::Type::Bin`)
-     * - `NumToken` (`Token::Type::Num`)
-     * - `BoolToken` (`Token::Type::Bool`)
-     */
+class Token {
+    public:
+    /** A token's type, the tag of the union holding its value */
     enum class Type {
-        /** Indicates that a token of this type can represent its value as Operator */
+        /** Indicates that a token of this type holds an operator */
         Op,
-        /** Indicates that a token of this type can represent its value as Binary */
+        /** Indicates that a token of this type holds a binary (or a quotient and remainder) */
         Bin,
-        /** Indicates that a token of this type can represent its value as number */
+        /** Indicates that a token of this type holds a number */
         Num,
-        /** Indicates that a token of this type can represent its value as bool */
-        Bool
+        /** Indicates that a token of this type holds a bool */
+        Bool,
+        /** Indicates that a token of this type refers to a variable by its index */
+        Var
     };
 
-    /** The token's primary type */
-    const Type type;
+    /**
+     * Creates a token of type `Type::Op`
+     * @param op the value this token holds
+     */
+    explicit Token(Op op) noexcept;
 
     /**
-     * Creates a value-less token of type `t`
-     * @param t the token's type
+     * Creates a token of type `Type::Bin`
+     * @param bin the value this token holds
      */
-    Token(Type t);
+    explicit Token(Binary bin) noexcept;
 
-    virtual ~Token() = default;
+    /**
+     * Creates a token of type `Type::Bin` holding the result of a division
+     * @param quotient the first value this token holds
+     * @param remainder the second value this token holds
+     */
+    Token(Binary quotient, Binary remainder) noexcept;
 
     /**
-     * @returns this token's value as instance of `Op` enum
-     *
-     * Is only guaranteed not to throw if `type` is `Type::Op`.
+     * Creates a token of type `Type::Num`
+     * @param n the value this token holds
      */
-    virtual Op op() const;
+    explicit Token(long n) noexcept;
 
     /**
-     * @returns this token's value as `Binary` instance
-     *
-     * Is only guaranteed not to throw if `type` is `Type::Bin`.
+     * Creates a token of type `Type::Bool`
+     * @param b the value this token holds
      */
-    virtual Binary bin() const;
+    explicit Token(bool b) noexcept;
 
     /**
-     * @returns this token's second value (if present) as `Binary` instance
+     * Creates a token of type `Type::Var`
+     * @param index the index of the variable this token refers to
      */
-    virtual Binary bin2() const;
+    static Token variable(std::size_t index) noexcept;
+
+    Token(const Token& other);
 
     /**
-     * @returns this token's value as number
-     *
-     * Is only guaranteed not to throw if `type` is `Type::Num`.
+     * Takes over `other`'s value, binaries are moved w/o copying their limbs
      */
-    virtual long num() const;
+    Token(Token&& other) noexcept;
+
+    Token& operator=(const Token& other);
+
+    Token& operator=(Token&& other) noexcept;
+
+    ~Token();
 
     /**
-     * @returns this token's value as bool
-     *
-     * Is only guaranteed not to throw if `type` is `Type::Bool`.
+     * @returns the token's type
+     */
+    Type type() const { return m_type; }
+
+    /**
+     * @returns this token's value as instance of `Op` enum, requires `type` to be `Type::Op`
+     */
+    Op op() const;
+
+    /**
+     * @returns this token's value as `Binary`, requires `type` to be `Type::Bin`
+     */
+    const Binary& bin() const &;
+
+    /**
+     * @returns this token's value as `Binary`, moved out of the token
      */
-    virtual bool boolean() const;
+    Binary bin() &&;
+
+    /**
+     * @returns whether this token holds a second value, i.e. the remainder of a division
+     */
+    bool has_bin2() const { return m_type == Type::Bin && m_pair; }
+
+    /**
+     * @returns this token's second value, requires `has_bin2`
+     */
+    const Binary& bin2() const;
+
+    /**
+     * @returns this token's value as number, requires `type` to be `Type::Num`
+     */
+    long num() const;
+
+    /**
+     * @returns this token's value as bool, requires `type` to be `Type::Bool`
+     */
+    bool boolean() const;
+
+    /**
+     * @returns the index of the variable this token refers to, requires `type` to be `Type::Var`
+     */
+    std::size_t var() const;
 
     /**
      * The token't string representation
      * @returns the string representation of this token
      */
-    virtual std::string to_str() const;
+    std::string to_str() const;
+
+    /**
+     * Writes this token's string representation to `os`
+     *
+     * Binaries are written directly, w/o building their string representation first.
+     *
+     * @param os the stream to write to
+     */
+    void print(std::ostream& os) const;
 
     /**
      * @returns this token's type as human readable string
      */
     std::string typeName() const;
-    
-    friend std::ostream& operator<<(std::ostream& os, Token& t);
 
-};
-
-/**
- * A token that holds a value which is representable as `Op`
- */
-struct OpToken final : public Token {
     /**
-     * Creates a Token of type `Token::Type::Op`
-     * @param op the value this token holds
+     * @returns a type as human readable string
      */
-    OpToken(Op op);
+    static std::string typeName(Type type);
 
-    Op op() const override;
+    friend std::ostream& operator<<(std::ostream& os, const Token& t);
 
     private:
-    Op m_op;
-};
+    /**
+     * Constructs the value of `other` into this token, which must not hold a value
+     */
+    void construct(const Token& other);
 
-/**
- * A token that holds a value which is representable as `Binary`
- */
-struct BinToken final : public Token {
     /**
-     * Creates a Token of type `Token::Type::Bin`
-     * @param bin the value this token holds
+     * Moves the value of `other` into this token, which must not hold a value
      */
-    BinToken(Binary bin);
+    void construct(Token&& other) noexcept;
 
-    Binary bin() const override;
+    /**
+     * Destroys the value of this token
+     */
+    void destroy() noexcept;
 
-    virtual std::string to_str() const override;
+    Type m_type;
 
-    private:
-    Binary m_bin;
+    /** Whether `m_bins` holds a quotient and remainder rather than a single binary */
+    bool m_pair;
+
+    union {
+        Op m_op;
+        long m_n;
+        bool m_b;
+        std::size_t m_var;
+        /** The binary (first element only) or the quotient and remainder */
+        Binary m_bins[2];
+    };
 };
 
 /**
- * A token that holds a two values which are representable as `Binary`
+ * Evaluates an expression to a single token containing its final value
+ * @param expr the expression to evaluate as string
+ * @throws if the expression is misformed in terms of syntax or types
+ */
+Token evaluate(const std::string& expr);
+
+/**
+ * Parses a single literal, written in binary or w/ a radix prefix like in expressions
+ * @param s the literal, e.g. '101', '0b101', '0o5', '0d5' or '0x5'
+ * @param n the literal's length
+ * @throws std::invalid_argument if `s` is not a valid literal
  */
-struct Bin2Token final : public Token {
+Binary literal(const char* s, std::size_t n);
+
+/**
+ * A prepared expression, compiled once and executed many times w/ different variable values
+ *
+ * Besides literals, the expression may contain variables, i.e. words of letters and underscores
+ * (except for the parity operator 'p') that stand for binaries, e.g. `(a & b) == c`. The
+ * expression is parsed and type checked when the program is compiled, which leaves a bytecode
+ * program of operations on the operand types already resolved. Executing it does not parse or
+ * check anything anymore.
+ *
+ * A program keeps its operand stacks between runs, so that repeated runs reuse their storage.
+ * It must therefore not be run while an arena (see `arena.hpp`) is installed that is reset before
+ * the program is destroyed.
+ *
+ *      Program program("(a & b) == c");
+ *      program.bind("a", Binary(5));
+ *      program.bind("b", Binary(3));
+ *      program.bind("c", Binary(1));
+ *      program.run(); // a token holding `true`
+ */
+class Program {
+    public:
     /**
-     * Creates a Token of type `Token::Type::Bin`
-     * @param b1 the first value this token holds
-     * @param b2 the second value this token holds
+     * Compiles an expression
+     * @param expr the expression to compile
+     * @throws std::invalid_argument if the expression is misformed in terms of syntax or types
      */
-    Bin2Token(Binary b1, Binary b2);
+    explicit Program(const std::string& expr);
 
-    Binary bin() const override;
+    /**
+     * @returns the names of the expression's variables, in the order of their first occurence
+     */
+    const std::vector<std::string>& variables() const { return m_names; }
 
-    Binary bin2() const override;
+    /**
+     * @returns the index of the variable `name`
+     * @throws std::invalid_argument if the expression has no such variable
+     */
+    std::size_t index(const std::string& name) const;
 
-    virtual std::string to_str() const override;
+    /**
+     * Sets the value of a variable for the following runs
+     * @param index the variable's index in `variables`
+     * @param value the variable's value
+     */
+    void bind(std::size_t index, const Binary& value);
 
-    private:
-    Binary m_bin1;
-    Binary m_bin2;
-};
+    void bind(std::size_t index, Binary&& value);
 
-/**
- * A token that holds a value which is representable as `long`
- */
-struct NumToken final : public Token {
     /**
-     * Creates a Token of type `Token::Type::Num`
-     * @param l the value this token holds
+     * Sets the value of a variable for the following runs
+     * @param name the variable's name
+     * @param value the variable's value
+     * @throws std::invalid_argument if the expression has no such variable
      */
-    NumToken(long l);
-
-    long num() const override;
+    void bind(const std::string& name, const Binary& value) { bind(index(name), value); }
 
-    virtual std::string to_str() const override;
+    /**
+     * Executes the program w/ the values bound to its variables
+     * @returns the expression's value
+     * @throws std::invalid_argument if a variable is not bound or a shift exceeds the addressable bits
+     * @throws std::domain_error if a subtraction is negative or a division is by 0
+     */
+    Token run();
 
     private:
-    long m_n;
-};
+    /** The program's operations, each w/ its operands' types resolved */
+    enum class Code : std::uint8_t {
+        /** Pushes the literal `arg` */
+        Literal,
+        /** Pushes the value of the variable `arg` */
+        Load,
+        And, Or, Xor, Add, Sub, Mul, Div, Concat, Shl, Shr,
+        /** A division that keeps the remainder, only ever the last operation */
+        DivRem,
+        Parity,
+        EqBin, NeqBin, GtBin, LtBin,
+        EqNum, NeqNum, GtNum, LtNum,
+        EqBool, NeqBool,
+    };
 
-/**
- * A token that holds a value which is representable as `bool`
- */
-struct BoolToken final : public Token {
-    /**
-     * Creates a Token of type `Token::Type::Bool`
-     * @param b the value this token holds
-     */
-    BoolToken(bool b);
+    struct Instruction {
+        Code code;
+        /** The index of the literal or variable, if any */
+        std::uint32_t arg;
+    };
 
-    bool boolean() const override;
+    std::vector<Instruction> m_code;
+    std::vector<Binary> m_literals;
+    std::vector<std::string> m_names;
+    std::vector<Binary> m_values;
 
-    virtual std::string to_str() const override;
+    /** Whether each variable has been bound */
+    std::vector<char> m_bound;
 
-    private:
-    bool m_b;
-};
+    /** The type of the expression's value */
+    Token::Type m_result;
 
-/**
- * Evaluates an expression to a single token containing its final value
- * @param expr the expression to evaluate as string
- * @throws if the expression is misformed in terms of syntax or types
- */
-std::shared_ptr<Token> evaluate(const std::string& expr);
+    /** The operand stacks, one per type, sized to the deepest nesting of the program */
+    std::vector<Binary> m_bins;
+    std::vector<long> m_nums;
+    std::vector<char> m_bools;
+};
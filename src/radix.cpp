@@ -0,0 +1,327 @@
+#include <algorithm>
+#include <cstring>
+#include "./radix.hpp"
+
+/** The value marking characters that are no digit in `digit_table` */
+static constexpr unsigned char INVALID = 0xff;
+
+/**
+ * @returns the value of every character as hexadecimal digit, `INVALID` for non-digits
+ */
+static const unsigned char* digit_table() {
+    static const struct Table {
+        unsigned char values[256];
+        Table() : values {} {
+            std::fill(values, values + 256, INVALID);
+            for (unsigned char d = 0; d < 10; d++) {
+                values['0' + d] = d;
+            }
+            for (unsigned char d = 0; d < 6; d++) {
+                values['a' + d] = static_cast<unsigned char>(10 + d);
+                values['A' + d] = static_cast<unsigned char>(10 + d);
+            }
+        }
+    } table;
+    return table.values;
+}
+
+/**
+ * @returns the value of the digit `c`, `INVALID` if it is none
+ */
+static unsigned char digit(const unsigned char* table, char c) {
+    return table[static_cast<unsigned char>(c)];
+}
+
+/**
+ * Expands 8 nibbles to the 8 hexadecimal digits they represent, most significant nibble first
+ *
+ * The nibbles are spread to one byte each and converted to ASCII in all bytes at once, where the
+ * carry of adding 6 into a byte's upper nibble tells the digits above 9 apart.
+ */
+static inline void format_nibbles(std::uint32_t nibbles, char* out) {
+    std::uint64_t x = nibbles;
+    x = (x | x << 16) & 0x0000ffff0000ffff;
+    x = (x | x << 8) & 0x00ff00ff00ff00ff;
+    x = (x | x << 4) & 0x0f0f0f0f0f0f0f0f;
+    const std::uint64_t letters = ((x + 0x0606060606060606) >> 4) & 0x0101010101010101;
+    x += 0x3030303030303030 + letters * ('a' - '0' - 10);
+    // the least significant nibble ended up in the lowest byte, but is the last digit
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    x = __builtin_bswap64(x);
+    std::memcpy(out, &x, 8);
+#else
+    for (std::size_t j = 0; j < 8; j++) {
+        out[j] = static_cast<char>(x >> (56 - 8 * j));
+    }
+#endif
+}
+
+/**
+ * Packs the values of 8 hexadecimal digits to 8 nibbles, the first digit being the most significant
+ *
+ * All 8 characters are validated and converted at once by SWAR: every byte must lie in '0' to '9'
+ * or, folded to lowercase, in 'a' to 'f', which is tested by adding range offsets into the bytes'
+ * top bits. A letter's value is its low nibble plus 9.
+ *
+ * @returns `false` if one of the characters is no hexadecimal digit
+ */
+static inline bool parse_nibbles(const unsigned char* table, const char* s, std::uint32_t& nibbles) {
+    std::uint64_t x;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    (void) table;
+    std::memcpy(&x, s, 8);
+    constexpr std::uint64_t ones = 0x0101010101010101, tops = 0x8080808080808080;
+    const std::uint64_t t = x | 0x2020202020202020;
+    const std::uint64_t digits = (x + (0x80 - '0') * ones) & ~(x + (0x7f - '9') * ones);
+    const std::uint64_t letters = (t + (0x80 - 'a') * ones) & ~(t + (0x7f - 'f') * ones);
+    if ((x & tops) || ((digits | letters) & tops) != tops) {
+        return false;
+    }
+    // the first character is the lowest byte, but the most significant digit
+    x = __builtin_bswap64((t & 0x0f0f0f0f0f0f0f0f) + ((t >> 6) & ones) * 9);
+#else
+    x = 0;
+    for (std::size_t j = 0; j < 8; j++) {
+        x |= std::uint64_t { digit(table, s[j]) } << (56 - 8 * j);
+    }
+    if (x & 0xf0f0f0f0f0f0f0f0) {
+        return false;
+    }
+#endif
+    x = (x | x >> 4) & 0x00ff00ff00ff00ff;
+    x = (x | x >> 8) & 0x0000ffff0000ffff;
+    nibbles = static_cast<std::uint32_t>(x | x >> 16);
+    return true;
+}
+
+/**
+ * Writes the 16 hexadecimal digits of `limb` to `out`, zero-padded
+ */
+static void format_hex_limb(std::uint64_t limb, char* out) {
+    format_nibbles(static_cast<std::uint32_t>(limb >> 32), out);
+    format_nibbles(static_cast<std::uint32_t>(limb), out + 8);
+}
+
+/**
+ * Expands 8 octal digits of 3 bits each to ASCII, most significant digit first
+ *
+ * Like `format_nibbles`, the digits are spread to one byte each by halving the groups of bits.
+ */
+static inline void format_triplets(std::uint32_t triplets, char* out) {
+    std::uint64_t x = triplets;
+    x = (x | x << 20) & 0x00000fff00000fff;
+    x = (x | x << 10) & 0x003f003f003f003f;
+    x = (x | x << 5) & 0x0707070707070707;
+    x += 0x3030303030303030;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    x = __builtin_bswap64(x);
+    std::memcpy(out, &x, 8);
+#else
+    for (std::size_t j = 0; j < 8; j++) {
+        out[j] = static_cast<char>(x >> (56 - 8 * j));
+    }
+#endif
+}
+
+/**
+ * Packs the values of 8 octal digits to 24 bits, the first digit being the most significant
+ *
+ * The characters are validated at once by SWAR like in `parse_nibbles`, the low 3 bits of '0' to
+ * '7' are their values.
+ *
+ * @returns `false` if one of the characters is no octal digit
+ */
+static inline bool parse_triplets(const unsigned char* table, const char* s, std::uint32_t& triplets) {
+    std::uint64_t x;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    (void) table;
+    std::memcpy(&x, s, 8);
+    constexpr std::uint64_t ones = 0x0101010101010101, tops = 0x8080808080808080;
+    const std::uint64_t digits = (x + (0x80 - '0') * ones) & ~(x + (0x7f - '7') * ones);
+    if ((x & tops) || (digits & tops) != tops) {
+        return false;
+    }
+    // the first character is the lowest byte, but the most significant digit
+    x = __builtin_bswap64(x & 0x0707070707070707);
+#else
+    x = 0;
+    for (std::size_t j = 0; j < 8; j++) {
+        x |= std::uint64_t { digit(table, s[j]) } << (56 - 8 * j);
+    }
+    if (x & 0xf8f8f8f8f8f8f8f8) {
+        return false;
+    }
+#endif
+    x = (x | x >> 5) & 0x003f003f003f003f;
+    x = (x | x >> 10) & 0x00000fff00000fff;
+    triplets = static_cast<std::uint32_t>((x | x >> 20) & 0xffffff);
+    return true;
+}
+
+/** The number of limbs whose bits make up a whole number of octal digits */
+static constexpr std::size_t OCT_GROUP_LIMBS = 3;
+
+/** The number of octal digits of `OCT_GROUP_LIMBS` limbs */
+static constexpr std::size_t OCT_GROUP_DIGITS = 64 * OCT_GROUP_LIMBS / 3;
+
+/**
+ * Writes the 64 octal digits of the 3 limbs `g` (least significant first) to `out`, zero-padded
+ */
+static void format_oct_group(const std::uint64_t* g, char* out) {
+    // 8 digits of 24 bits each, the most significant first
+    for (std::size_t u = 8; u-- > 0; ) {
+        const std::size_t pos = 24 * u, l = pos / 64, shift = pos % 64;
+        std::uint64_t v = g[l] >> shift;
+        if (shift > 40) {
+            v |= g[l + 1] << (64 - shift);
+        }
+        format_triplets(static_cast<std::uint32_t>(v & 0xffffff), out + 8 * (7 - u));
+    }
+}
+
+/**
+ * Packs the 64 octal digits at `s` into the 3 limbs `g` (least significant first)
+ *
+ * @returns `false` if one of the characters is no octal digit
+ */
+static bool parse_oct_group(const unsigned char* table, const char* s, std::uint64_t* g) {
+    g[0] = g[1] = g[2] = 0;
+    for (std::size_t u = 0; u < 8; u++) {
+        std::uint32_t triplets;
+        if (!parse_triplets(table, s + 8 * (7 - u), triplets)) {
+            return false;
+        }
+        const std::size_t pos = 24 * u, l = pos / 64, shift = pos % 64;
+        g[l] |= std::uint64_t { triplets } << shift;
+        if (shift > 40) {
+            g[l + 1] |= std::uint64_t { triplets } >> (64 - shift);
+        }
+    }
+    return true;
+}
+
+std::string radix::format(const std::uint64_t* a, std::size_t n, unsigned int bits) {
+    std::string out;
+    write(a, n, bits, [](void* context, const char* chars, std::size_t count) {
+        static_cast<std::string*>(context)->append(chars, count);
+    }, &out);
+    return out;
+}
+
+void radix::write(const std::uint64_t* a, std::size_t n, unsigned int bits,
+                  void (*sink)(void*, const char*, std::size_t), void* context) {
+    if (!n) {
+        return;
+    }
+    while (n > 1 && !a[n - 1]) {
+        n--;
+    }
+    const std::size_t width = a[n - 1] ? 64 - static_cast<std::size_t>(__builtin_clzll(a[n - 1])) : 1;
+    const std::size_t digits = (64 * (n - 1) + width + bits - 1) / bits;
+
+    // the digits are formatted into a fixed buffer of 128 limbs' hexadecimal digits (32 octal groups)
+    constexpr std::size_t CHUNK_DIGITS = 128 * 16;
+    char buffer[CHUNK_DIGITS];
+    std::size_t fill = 0;
+
+    if (bits == 4) {
+        // only the most significant limb has fewer than 16 digits
+        char top[16];
+        format_hex_limb(a[n - 1], top);
+        const std::size_t head = digits - 16 * (n - 1);
+        std::copy(top + 16 - head, top + 16, buffer);
+        fill = head;
+        for (std::size_t i = n - 1; i-- > 0; ) {
+            if (fill + 16 > CHUNK_DIGITS) {
+                sink(context, buffer, fill);
+                fill = 0;
+            }
+            format_hex_limb(a[i], buffer + fill);
+            fill += 16;
+        }
+    } else {
+        // every 3 limbs make up 64 digits, only the most significant group has fewer, it is padded w/ zeros
+        const std::size_t groups = (n + OCT_GROUP_LIMBS - 1) / OCT_GROUP_LIMBS;
+        std::uint64_t padded[OCT_GROUP_LIMBS] = {};
+        std::copy(a + OCT_GROUP_LIMBS * (groups - 1), a + n, padded);
+        char top[OCT_GROUP_DIGITS];
+        format_oct_group(padded, top);
+        const std::size_t head = digits - OCT_GROUP_DIGITS * (groups - 1);
+        std::copy(top + OCT_GROUP_DIGITS - head, top + OCT_GROUP_DIGITS, buffer);
+        fill = head;
+        for (std::size_t g = groups - 1; g-- > 0; ) {
+            if (fill + OCT_GROUP_DIGITS > CHUNK_DIGITS) {
+                sink(context, buffer, fill);
+                fill = 0;
+            }
+            format_oct_group(a + OCT_GROUP_LIMBS * g, buffer + fill);
+            fill += OCT_GROUP_DIGITS;
+        }
+    }
+    sink(context, buffer, fill);
+}
+
+/**
+ * @returns the position of the first character in `s` that is no digit below `limit`, `n` if there is none
+ */
+static std::size_t find_invalid(const char* s, std::size_t n, unsigned int limit) {
+    const unsigned char* table = digit_table();
+    std::size_t i = 0;
+    while (i < n && digit(table, s[i]) < limit) {
+        i++;
+    }
+    return i;
+}
+
+std::size_t radix::parse(std::uint64_t* r, const char* s, std::size_t n, unsigned int bits) {
+    const unsigned char* table = digit_table();
+    const std::size_t limbs = (n * bits + 63) / 64;
+    std::fill(r, r + limbs, 0);
+
+    if (bits == 4) {
+        // every 16 digits from the end make up one limb, the leading digits may make up a shorter one
+        const std::size_t full = n / 16, head = n % 16;
+        for (std::size_t l = 0; l < full; l++) {
+            const char* p = s + n - 16 * (l + 1);
+            std::uint32_t high, low;
+            if (!parse_nibbles(table, p, high) || !parse_nibbles(table, p + 8, low)) {
+                return find_invalid(s, n, 16);
+            }
+            r[l] = std::uint64_t { high } << 32 | low;
+        }
+        if (head) {
+            std::uint64_t limb = 0;
+            for (std::size_t i = 0; i < head; i++) {
+                const unsigned char v = digit(table, s[i]);
+                if (v >= 16) {
+                    return i;
+                }
+                limb = (limb << 4) | v;
+            }
+            r[full] = limb;
+        }
+        return n;
+    }
+
+    // every 64 digits from the end make up 3 limbs, the leading digits may make up fewer
+    const std::size_t full = n / OCT_GROUP_DIGITS, head = n % OCT_GROUP_DIGITS;
+    for (std::size_t g = 0; g < full; g++) {
+        if (!parse_oct_group(table, s + n - OCT_GROUP_DIGITS * (g + 1), r + OCT_GROUP_LIMBS * g)) {
+            return find_invalid(s, n, 8);
+        }
+    }
+    const std::size_t invalid = find_invalid(s, head, 8);
+    if (invalid != head) {
+        return invalid;
+    }
+    std::uint64_t* top = r + OCT_GROUP_LIMBS * full;
+    for (std::size_t d = 0; d < head; d++) {
+        const std::uint64_t v = digit(table, s[head - 1 - d]);
+        const std::size_t pos = 3 * d, limb = pos / 64, shift = pos % 64;
+        top[limb] |= v << shift;
+        if (shift > 61) {
+            top[limb + 1] |= v >> (64 - shift);
+        }
+    }
+    return n;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Conversion between numbers on limb arrays (least significant limb first) and digits of a
+ * power-of-two radix (octal, hexadecimal)
+ *
+ * Every digit maps to a fixed group of bits, so the conversion is linear and works a limb at a time:
+ * hexadecimal limbs are expanded to / packed from 16 digits by SWAR arithmetic and a digit table,
+ * octal digits likewise in groups of 3 limbs, which hold exactly 64 digits.
+ */
+namespace radix {
+
+    /**
+     * Formats a number of `n` limbs in the radix `2^bits`
+     *
+     * @param bits the number of bits per digit, `3` (octal) or `4` (hexadecimal)
+     * @returns the lowercase digits w/o leading zeros ("0" for zero, "" for `n == 0`)
+     */
+    std::string format(const std::uint64_t* a, std::size_t n, unsigned int bits);
+
+    /**
+     * Formats a number of `n` limbs in the radix `2^bits` chunk by chunk, w/o building a string of
+     * the full width (see `format`)
+     *
+     * @param bits the number of bits per digit, `3` (octal) or `4` (hexadecimal)
+     * @param sink receives `context` and every chunk of digits, the most significant first
+     * @param context passed to `sink` unchanged
+     */
+    void write(const std::uint64_t* a, std::size_t n, unsigned int bits,
+               void (*sink)(void* context, const char* chars, std::size_t n), void* context);
+
+    /**
+     * Parses `n` digits of the radix `2^bits`, the most significant digit first
+     *
+     * Both lowercase and uppercase hexadecimal digits are accepted.
+     *
+     * @param r the array of `ceil(n * bits / 64)` limbs receiving the number
+     * @param bits the number of bits per digit, `3` (octal) or `4` (hexadecimal)
+     * @returns the position of the first invalid character, `n` if there is none
+     */
+    std::size_t parse(std::uint64_t* r, const char* s, std::size_t n, unsigned int bits);
+}
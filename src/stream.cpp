@@ -0,0 +1,225 @@
+#include <algorithm>
+#include <fstream>
+#include <future>
+#include <stdexcept>
+#include <vector>
+#include "./stream.hpp"
+#include "./archive.hpp"
+#include "./arith.hpp"
+#include "./kernels.hpp"
+
+std::size_t stream::chunk_limbs = std::size_t { 1 } << 17;
+
+/**
+ * @returns `file` after checking that it could be opened
+ * @throws std::runtime_error if it could not
+ */
+template<typename Stream>
+static Stream& opened(Stream& file, const std::string& path) {
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open '" + path + "'");
+    }
+    return file;
+}
+
+/**
+ * @returns the number of limbs of a number of `bits` bits
+ */
+static std::uint64_t limbs_for(std::uint64_t bits) {
+    return bits / 64 + (bits % 64 != 0);
+}
+
+/**
+ * An archive that is read double-buffered
+ *
+ * While the caller processes one chunk the next one is read into the other buffer by a background
+ * task. All chunks but the last hold `stream::chunk_limbs` limbs, so the chunks of several sources
+ * cover the same limb indices.
+ */
+class Source {
+    public:
+    /**
+     * Opens an archive and starts reading its first chunk
+     */
+    explicit Source(const std::string& path)
+        : m_file { path, std::ios::binary }
+        , m_reader { opened(m_file, path) }
+        , m_chunk { stream::chunk_limbs }
+        , m_current(m_chunk)
+        , m_next(m_chunk)
+    {
+        prefetch();
+    }
+
+    std::uint64_t bits() const { return m_reader.bits(); }
+
+    std::uint64_t limbs() const { return m_reader.limbs(); }
+
+    /**
+     * Retrieves the next chunk
+     *
+     * @param chunk receives a pointer to the chunk's limbs, valid until the next call
+     * @returns the number of limbs in the chunk, `0` once all limbs have been retrieved
+     * @throws std::invalid_argument if the archive is truncated or corrupt
+     */
+    std::size_t next(const std::uint64_t*& chunk) {
+        if (!m_pending.valid()) {
+            return 0;
+        }
+        const std::size_t n = m_pending.get();
+        std::swap(m_current, m_next);
+        prefetch();
+        chunk = m_current.data();
+        return n;
+    }
+
+    private:
+    /**
+     * Starts reading the next chunk into `m_next`, unless all limbs have been read
+     */
+    void prefetch() {
+        if (m_reader.remaining()) {
+            std::uint64_t* target = m_next.data();
+            m_pending = std::async(std::launch::async, [this, target]() {
+                return m_reader.read(target, m_chunk);
+            });
+        }
+    }
+
+    std::ifstream m_file;
+    archive::Reader m_reader;
+    const std::size_t m_chunk;
+
+    /** The buffer holding the chunk handed out by `next` */
+    std::vector<std::uint64_t> m_current;
+
+    /** The buffer the background task reads to */
+    std::vector<std::uint64_t> m_next;
+
+    /** The background read, declared last so that it is waited for before the buffers are released */
+    std::future<std::size_t> m_pending;
+};
+
+/**
+ * An archive that is written chunk by chunk, its checksum is patched when it is finished
+ */
+class Sink {
+    public:
+    Sink(const std::string& path, std::uint64_t bits)
+        : m_file { path, std::ios::binary | std::ios::trunc }
+        , m_writer { opened(m_file, path), bits }
+        {}
+
+    void write(const std::uint64_t* a, std::size_t n) { m_writer.write(a, n); }
+
+    void finish() { m_writer.finish(); }
+
+    private:
+    std::ofstream m_file;
+    archive::Writer m_writer;
+};
+
+void stream::apply(Bitwise op, const std::string& a, const std::string& b, const std::string& out) {
+    Source sa(a), sb(b);
+    // '&' ends w/ the shorter operand, '|' and '^' treat the shorter one's missing limbs as 0
+    const bool shorter = op == Bitwise::And;
+    const std::uint64_t bits = shorter ? std::min(sa.bits(), sb.bits()) : std::max(sa.bits(), sb.bits());
+    Sink sink(out, bits);
+
+    const auto kernel = op == Bitwise::And ? kernels::and_n : op == Bitwise::Or ? kernels::or_n : kernels::xor_n;
+    std::vector<std::uint64_t> result(chunk_limbs);
+    const std::uint64_t* ca = nullptr;
+    const std::uint64_t* cb = nullptr;
+    for (std::uint64_t written = 0; written < limbs_for(bits); ) {
+        const std::size_t na = sa.next(ca), nb = sb.next(cb);
+        const std::size_t common = std::min(na, nb);
+        kernel(result.data(), ca, cb, common);
+        if (!shorter) {
+            if (na > common) {
+                std::copy(ca + common, ca + na, result.data() + common);
+            } else {
+                std::copy(cb + common, cb + nb, result.data() + common);
+            }
+        }
+        const std::size_t n = shorter ? common : std::max(na, nb);
+        if (!n) {
+            break;
+        }
+        sink.write(result.data(), n);
+        written += n;
+    }
+    sink.finish();
+}
+
+void stream::concat(const std::string& a, const std::string& b, const std::string& out) {
+    Source sa(a), sb(b);
+    const std::uint64_t bits = sa.bits() + sb.bits();
+    const std::uint64_t limbs = limbs_for(bits);
+    const unsigned int shift = static_cast<unsigned int>(sb.bits() % 64);
+    Sink sink(out, bits);
+
+    // `b` makes up the low limbs, its partial most significant limb is completed by `a`'s low bits
+    const std::uint64_t* chunk = nullptr;
+    std::uint64_t written = 0, pending = 0;
+    for (std::size_t n; (n = sb.next(chunk)) != 0; ) {
+        if (shift && written + n == sb.limbs()) {
+            pending = chunk[--n] & ((std::uint64_t { 1 } << shift) - 1);
+        }
+        sink.write(chunk, n);
+        written += n;
+    }
+
+    std::vector<std::uint64_t> shifted(chunk_limbs);
+    for (std::size_t n; (n = sa.next(chunk)) != 0; ) {
+        if (shift) {
+            for (std::size_t i = 0; i < n; i++) {
+                shifted[i] = pending | chunk[i] << shift;
+                pending = chunk[i] >> (64 - shift);
+            }
+            chunk = shifted.data();
+        }
+        n = static_cast<std::size_t>(std::min<std::uint64_t>(n, limbs - written));
+        sink.write(chunk, n);
+        written += n;
+    }
+    if (written < limbs) {
+        sink.write(&pending, 1);
+    }
+    sink.finish();
+}
+
+long stream::parity(const std::string& a) {
+    Source sa(a);
+    std::uint64_t ones = 0;
+    const std::uint64_t* chunk = nullptr;
+    for (std::size_t n; (n = sa.next(chunk)) != 0; ) {
+        ones += kernels::popcount(chunk, n);
+    }
+    return static_cast<long>(ones);
+}
+
+int stream::compare(const std::string& a, const std::string& b) {
+    Source sa(a), sb(b);
+    int result = 0;
+    const std::uint64_t* ca = nullptr;
+    const std::uint64_t* cb = nullptr;
+    for (;;) {
+        const std::size_t na = sa.next(ca), nb = sb.next(cb);
+        if (!na && !nb) {
+            break;
+        }
+        // every chunk is more significant than the previous ones, and the limbs only one operand has
+        // left are more significant than the common ones
+        const std::size_t common = std::min(na, nb);
+        const int c = arith::cmp_n(ca, cb, common);
+        if (c) {
+            result = c < 0 ? -1 : 1;
+        }
+        if (std::any_of(ca + common, ca + na, [](std::uint64_t l) { return l != 0; })) {
+            result = 1;
+        } else if (std::any_of(cb + common, cb + nb, [](std::uint64_t l) { return l != 0; })) {
+            result = -1;
+        }
+    }
+    return result;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * Out-of-core evaluation of operations on numbers stored in archive files (see `archive.hpp`)
+ *
+ * Operands are streamed from their files in aligned chunks of `chunk_limbs` limbs, so neither the
+ * operands nor the result ever have to fit into memory. Every operand is read double-buffered: while
+ * one chunk is processed the next one is read by a background task, which overlaps I/O and compute.
+ * Results that are numbers are written to an output archive chunk by chunk.
+ *
+ * The operations match their Binary counterparts, e.g. streaming `a & b` to a file yields an archive
+ * that loads to `Binary::load(a) & Binary::load(b)`.
+ */
+namespace stream {
+
+    /**
+     * The number of limbs read per chunk and operand, may be tuned at runtime
+     */
+    extern std::size_t chunk_limbs;
+
+    /**
+     * The bitwise operations that can be streamed
+     */
+    enum class Bitwise {
+        And,
+        Or,
+        Xor,
+    };
+
+    /**
+     * Applies a bitwise operation to two archived numbers
+     *
+     * @param op the operation to apply
+     * @param a the path of the archive of the left operand
+     * @param b the path of the archive of the right operand
+     * @param out the path of the archive receiving the result (created or truncated)
+     * @throws std::invalid_argument if an operand is no valid archive
+     * @throws std::runtime_error if a file cannot be opened or written
+     */
+    void apply(Bitwise op, const std::string& a, const std::string& b, const std::string& out);
+
+    /**
+     * Concatenates two archived numbers (see `Binary::concat`)
+     *
+     * The width of `b` is taken from its header, which equals its size for archives written by
+     * `Binary::save`.
+     *
+     * @param a the path of the archive of the number that makes up the high bits
+     * @param b the path of the archive of the number that makes up the low bits
+     * @param out the path of the archive receiving the result (created or truncated)
+     * @throws std::invalid_argument if an operand is no valid archive
+     * @throws std::runtime_error if a file cannot be opened or written
+     */
+    void concat(const std::string& a, const std::string& b, const std::string& out);
+
+    /**
+     * Calculates an archived number's parity, i.e. its number of 1s
+     *
+     * @param a the path of the archive
+     * @throws std::invalid_argument if `a` is no valid archive
+     * @throws std::runtime_error if `a` cannot be opened
+     */
+    long parity(const std::string& a);
+
+    /**
+     * Compares two archived numbers
+     *
+     * The limbs are streamed least significant first, the most significant differing limb decides.
+     *
+     * @returns 0 if both are equivalent, < 0 if `a` is less than `b`, > 0 otherwise
+     * @throws std::invalid_argument if an operand is no valid archive
+     * @throws std::runtime_error if a file cannot be opened
+     */
+    int compare(const std::string& a, const std::string& b);
+}
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "./view.hpp"
+#include "./archive.hpp"
+#include "./arith.hpp"
+#include "./kernels.hpp"
+
+/**
+ * Compares two normalized numbers given by their limbs and sizes (like `Binary::compare`)
+ */
+static int compare_limbs(const std::uint64_t* a, std::size_t an, std::size_t asize,
+                         const std::uint64_t* b, std::size_t bn, std::size_t bsize) {
+    // normalized numbers of different width cannot be equal, except for `0` and the *empty* number
+    if (asize != bsize && (asize > 1 || bsize > 1)) {
+        return asize < bsize ? -1 : 1;
+    } else if (an == bn) {
+        return arith::cmp_n(a, b, an);
+    } else {
+        const std::uint64_t a0 = an ? a[0] : 0, b0 = bn ? b[0] : 0;
+        return a0 < b0 ? -1 : a0 > b0;
+    }
+}
+
+BinaryView::BinaryView(const std::string& path)
+    : m_map { nullptr }
+    , m_length { 0 }
+    , m_limbs { nullptr }
+    , m_count { 0 }
+    , m_stored { 0 }
+    , m_checksum { archive::CHECKSUM_SEED }
+    , m_size { 0 }
+    , m_parity { -1 }
+{
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    // archived limbs are little endian and cannot be used in place
+    throw std::runtime_error("BinaryView requires a little endian host");
+#endif
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open '" + path + "': " + std::strerror(errno));
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0) {
+        const int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Cannot stat '" + path + "': " + std::strerror(error));
+    }
+    const std::size_t length = static_cast<std::size_t>(st.st_size);
+    if (length < archive::HEADER_SIZE) {
+        ::close(fd);
+        throw std::invalid_argument("Archive is truncated, expected a header of " + std::to_string(archive::HEADER_SIZE) + " bytes");
+    }
+    void* map = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    const int error = errno;
+    // the mapping stays valid after the file is closed
+    ::close(fd);
+    if (map == MAP_FAILED) {
+        throw std::runtime_error("Cannot map '" + path + "': " + std::strerror(error));
+    }
+    m_map = map;
+    m_length = length;
+    ::madvise(m_map, m_length, MADV_SEQUENTIAL);
+
+    const char* bytes = static_cast<const char*>(m_map);
+    archive::Header header;
+    try {
+        header = archive::parse_header(bytes);
+    } catch (...) {
+        ::munmap(m_map, m_length);
+        throw;
+    }
+    if (header.limbs > (length - archive::HEADER_SIZE) / 8) {
+        ::munmap(m_map, m_length);
+        throw std::invalid_argument("Archive is truncated, expected " + std::to_string(header.limbs) + " limbs");
+    }
+    // the header's size is a multiple of 8 and the mapping is page aligned, so are the limbs
+    m_limbs = reinterpret_cast<const std::uint64_t*>(bytes + archive::HEADER_SIZE);
+    m_stored = static_cast<std::size_t>(header.limbs);
+    m_checksum = header.checksum;
+
+    // normalizes the same way Binary does, only the most significant pages are touched
+    m_count = m_stored;
+    while (m_count > 1 && !m_limbs[m_count - 1]) {
+        m_count--;
+    }
+    if (m_count) {
+        const std::uint64_t top = m_limbs[m_count - 1];
+        m_size = std::max<std::size_t>(1, 64 * (m_count - 1) + (top ? 64 - static_cast<std::size_t>(__builtin_clzll(top)) : 0));
+    }
+}
+
+BinaryView::BinaryView(BinaryView&& other) noexcept
+    : m_map { nullptr }
+    , m_length { 0 }
+    , m_limbs { nullptr }
+    , m_count { 0 }
+    , m_stored { 0 }
+    , m_checksum { archive::CHECKSUM_SEED }
+    , m_size { 0 }
+    , m_parity { -1 }
+{
+    *this = std::move(other);
+}
+
+BinaryView& BinaryView::operator=(BinaryView&& other) noexcept {
+    if (this != &other) {
+        if (m_map) {
+            ::munmap(m_map, m_length);
+        }
+        m_map = other.m_map;
+        m_length = other.m_length;
+        m_limbs = other.m_limbs;
+        m_count = other.m_count;
+        m_stored = other.m_stored;
+        m_checksum = other.m_checksum;
+        m_size = other.m_size;
+        m_parity = other.m_parity;
+        other.m_map = nullptr;
+        other.m_length = 0;
+        other.m_limbs = nullptr;
+        other.m_count = 0;
+        other.m_stored = 0;
+        other.m_checksum = archive::CHECKSUM_SEED;
+        other.m_size = 0;
+        other.m_parity = -1;
+    }
+    return *this;
+}
+
+BinaryView::~BinaryView() {
+    if (m_map) {
+        ::munmap(m_map, m_length);
+    }
+}
+
+bool BinaryView::verify() const {
+    return archive::checksum(archive::CHECKSUM_SEED, m_limbs, m_stored) == m_checksum;
+}
+
+int BinaryView::compare(const BinaryView& other) const {
+    return compare_limbs(m_limbs, m_count, m_size, other.m_limbs, other.m_count, other.m_size);
+}
+
+int BinaryView::compare(const Binary& other) const {
+    const LimbVector& limbs = lazy::Access::limbs(other);
+    return compare_limbs(m_limbs, m_count, m_size, limbs.data(), limbs.size(), lazy::Access::size(other));
+}
+
+long BinaryView::parity() const {
+    if (m_parity < 0) {
+        m_parity = static_cast<long>(kernels::popcount(m_limbs, m_count));
+    }
+    return m_parity;
+}
+
+unsigned long long int BinaryView::to_l() const {
+    return m_count ? m_limbs[0] : 0;
+}
+
+Binary BinaryView::slice(std::size_t from, std::size_t n) const {
+    const std::size_t count = n / 64 + (n % 64 != 0);
+    LimbVector limbs(count, 0);
+    const std::size_t first = from / 64;
+    if (first < m_count) {
+        // one more limb than the result has supplies the bits shifted in from above
+        const std::size_t len = std::min(count + 1, m_count - first);
+        if (from % 64) {
+            LimbVector shifted(len);
+            arith::rshift(shifted.data(), m_limbs + first, len, static_cast<unsigned int>(from % 64));
+            std::copy(shifted.begin(), shifted.begin() + std::min(count, len), limbs.begin());
+        } else {
+            std::copy(m_limbs + first, m_limbs + first + std::min(count, len), limbs.begin());
+        }
+        if (n % 64) {
+            limbs.back() &= (std::uint64_t { 1 } << (n % 64)) - 1;
+        }
+    }
+    Binary result;
+    lazy::Access::assign(result, std::move(limbs), n);
+    return result;
+}
+
+Binary BinaryView::to_binary() const {
+    LimbVector limbs(m_count);
+    std::copy(m_limbs, m_limbs + m_count, limbs.begin());
+    Binary result;
+    lazy::Access::assign(result, std::move(limbs), m_size);
+    return result;
+}
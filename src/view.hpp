@@ -0,0 +1,163 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "./binary.hpp"
+#include "./cached.hpp"
+#include "./lazy.hpp"
+
+/**
+ * A read-only number backed by a memory mapped archive file (see `archive.hpp`)
+ *
+ * Opening a view maps the file instead of reading it, so its limbs are used in place, straight from
+ * the page cache, and only the pages an operation touches are ever loaded. The mapping is advised
+ * for sequential access, which suits the scans most operations perform.
+ *
+ * Operations that yield a number (bitwise operators, `slice`) produce a new Binary, all others
+ * work directly on the mapped limbs.
+ *
+ * @example
+ *      BinaryView v("huge.bnry");
+ *      v.parity();                 // scans the mapped pages
+ *      Binary low = v.slice(0, 64); // copies only the limbs involved
+ */
+class BinaryView {
+    public:
+    /**
+     * Maps an archive file
+     *
+     * The header is validated, the checksum is not (see `verify`), as that would read the whole file.
+     *
+     * @param path the path of the archive file
+     * @throws std::runtime_error if the file cannot be opened or mapped
+     * @throws std::invalid_argument if the file is no archive or is truncated
+     */
+    explicit BinaryView(const std::string& path);
+
+    BinaryView(const BinaryView& other) = delete;
+
+    /**
+     * Takes over `other`'s mapping, `other` is left *empty*
+     */
+    BinaryView(BinaryView&& other) noexcept;
+
+    BinaryView& operator=(const BinaryView& other) = delete;
+
+    BinaryView& operator=(BinaryView&& other) noexcept;
+
+    /**
+     * Unmaps the file
+     */
+    ~BinaryView();
+
+    /**
+     * @returns the number of bits of the value, w/o leading zeros (`0` for an *empty* number)
+     */
+    std::size_t size() const { return m_size; }
+
+    /**
+     * Verifies the archive's checksum, reading all mapped limbs
+     *
+     * @returns whether the limbs match the checksum stored in the header
+     */
+    bool verify() const;
+
+    /**
+     * Compares the value to a number
+     *
+     * @returns 0 if both are equivalent, < 0 if `this` is less than `other`, > 0 otherwise
+     */
+    int compare(const BinaryView& other) const;
+    int compare(const Binary& other) const;
+
+    bool operator==(const BinaryView& rhs) const { return compare(rhs) == 0; }
+    bool operator!=(const BinaryView& rhs) const { return compare(rhs) != 0; }
+    bool operator<(const BinaryView& rhs) const { return compare(rhs) < 0; }
+    bool operator>(const BinaryView& rhs) const { return compare(rhs) > 0; }
+
+    bool operator==(const Binary& rhs) const { return compare(rhs) == 0; }
+    bool operator!=(const Binary& rhs) const { return compare(rhs) != 0; }
+    bool operator<(const Binary& rhs) const { return compare(rhs) < 0; }
+    bool operator>(const Binary& rhs) const { return compare(rhs) > 0; }
+
+    /**
+     * Calculates the value's parity, i.e. its number of 1s
+     *
+     * The result is cached after the first call.
+     *
+     * @returns the parity of the value
+     */
+    long parity() const;
+
+    /**
+     * Converts the value to number base 10
+     *
+     * Overflows like `Binary::to_l`.
+     *
+     * @returns the value's least significant 64 bits
+     */
+    unsigned long long int to_l() const;
+
+    /**
+     * Copies a range of bits to a new Binary
+     *
+     * @example
+     *      // v equals 110101
+     *      v.slice(1, 3); // equals 10
+     *
+     * @param from the position of the range's least significant bit
+     * @param n the number of bits in the range, bits beyond the value's size are 0
+     * @returns the bits `[from, from + n)` of the value (*empty* if `n` is 0)
+     */
+    Binary slice(std::size_t from, std::size_t n) const;
+
+    /**
+     * Copies the whole value to a new Binary
+     */
+    Binary to_binary() const;
+
+    /**
+     * @returns the value as operand of a lazily evaluated bitwise expression (see `lazy.hpp`)
+     */
+    lazy::Ref ref() const { return lazy::Ref(m_limbs, m_count, m_size); }
+
+    Binary operator&(const BinaryView& rhs) const { return ref() & rhs.ref(); }
+    Binary operator|(const BinaryView& rhs) const { return ref() | rhs.ref(); }
+    Binary operator^(const BinaryView& rhs) const { return ref() ^ rhs.ref(); }
+
+    Binary operator&(const Binary& rhs) const { return ref() & rhs; }
+    Binary operator|(const Binary& rhs) const { return ref() | rhs; }
+    Binary operator^(const Binary& rhs) const { return ref() ^ rhs; }
+
+    private:
+    /** The start of the mapping, i.e. of the archive's header */
+    void* m_map;
+
+    /** The length of the mapping in bytes */
+    std::size_t m_length;
+
+    /** The mapped limbs, least significant first */
+    const std::uint64_t* m_limbs;
+
+    /** The number of limbs w/o leading zero limbs (but at least one, unless *empty*) */
+    std::size_t m_count;
+
+    /** The number of limbs following the header */
+    std::size_t m_stored;
+
+    /** The checksum stored in the header */
+    std::uint64_t m_checksum;
+
+    std::size_t m_size;
+
+    mutable Cached<long> m_parity;
+};
+
+inline bool operator==(const Binary& lhs, const BinaryView& rhs) { return rhs.compare(lhs) == 0; }
+inline bool operator!=(const Binary& lhs, const BinaryView& rhs) { return rhs.compare(lhs) != 0; }
+inline bool operator<(const Binary& lhs, const BinaryView& rhs) { return rhs.compare(lhs) > 0; }
+inline bool operator>(const Binary& lhs, const BinaryView& rhs) { return rhs.compare(lhs) < 0; }
+
+inline Binary operator&(const Binary& lhs, const BinaryView& rhs) { return rhs & lhs; }
+inline Binary operator|(const Binary& lhs, const BinaryView& rhs) { return rhs | lhs; }
+inline Binary operator^(const Binary& lhs, const BinaryView& rhs) { return rhs ^ lhs; }
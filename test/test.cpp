@@ -1,8 +1,63 @@
+#include <atomic>
 #include <cassert>
 #include <vector>
 #include <sstream>
+#include <fstream>
+#include <cstdio>
 #include <iostream>
+#include <unordered_map>
+#include <unordered_set>
+#include <stdexcept>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <new>
 #include "../src/binary.hpp"
+#include "../src/fixed.hpp"
+#include "../src/constant.hpp"
+#include "../src/kernels.hpp"
+#include "../src/arith.hpp"
+#include "../src/archive.hpp"
+#include "../src/view.hpp"
+#include "../src/stream.hpp"
+#include "../src/parallel.hpp"
+#include "../src/limbs.hpp"
+#include "../src/lazy.hpp"
+#include "../src/arena.hpp"
+
+/** The number of heap allocations performed so far (by any thread), used to check the allocation-free paths */
+static std::atomic<std::size_t> allocations { 0 };
+
+// the replacements are kept out of line: inlined into a caller, `std::malloc` and `std::free` would not
+// appear to pair up w/ the `operator new` and `operator delete` they are called through
+[[gnu::noinline]] void* operator new(std::size_t size) {
+    ++allocations;
+    if (void* p = std::malloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete[](void* p) noexcept {
+    operator delete(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    operator delete(p);
+}
 
 int main() {
     assert(Binary().to_l() == 0);
@@ -40,6 +95,22 @@ int main() {
     assert((Binary(5) ^ Binary(0)) == Binary(5));
     assert((Binary(4) ^ Binary(1)) == Binary(5));
 
+    assert((Binary(5) + Binary(7)) == Binary(12));
+    assert((Binary(5) + Binary(0)) == Binary(5));
+    assert((Binary(~0ULL) + Binary(1)).to_str() == "1" + std::string(64, '0'));
+
+    assert((Binary(7) - Binary(5)) == Binary(2));
+    assert((Binary(5) - Binary(5)) == Binary(0));
+    assert((Binary(5) - Binary(0)) == Binary(5));
+    { bool thrown = false; try { Binary(5) - Binary(7); } catch (std::domain_error&) { thrown = true; } assert(thrown); }
+    { Binary b(5); b += Binary(3); assert(b == Binary(8)); b -= Binary(8); assert(b == Binary(0)); }
+
+    assert((Binary(5) * Binary(7)) == Binary(35));
+    assert((Binary(5) * Binary(0)) == Binary(0));
+    assert((Binary(5) * Binary(5)) == Binary(25));
+    assert((Binary(~0ULL) * Binary(~0ULL)).to_str() == std::string(63, '1') + "0" + std::string(63, '0') + "1");
+    { Binary b(6); b *= Binary(7); assert(b == Binary(42)); }
+
     assert((Binary(1) / Binary(1)) == Binary(1));
     assert((Binary(5) / Binary(7)) == Binary(0));
     assert((Binary(5) / Binary(1)) == Binary(5));
@@ -52,6 +123,16 @@ int main() {
     assert(Binary(4).div(Binary(2)) == std::make_tuple(Binary(2), Binary(0)));
     assert(Binary(5).div(Binary(2)) == std::make_tuple(Binary(2), Binary(1)));
 
+    assert((Binary(5) << 2) == Binary(20));
+    assert((Binary(5) << 0) == Binary(5));
+    assert((Binary(0) << 70) == Binary(0));
+    assert((Binary(5) << 126).to_str() == "101" + std::string(126, '0'));
+    assert((Binary(5) >> 2) == Binary(1));
+    assert((Binary(5) >> 3) == Binary(0));
+    assert((Binary(5) >> 200) == Binary(0));
+    assert(((Binary(5) << 126) >> 125) == Binary(10));
+    { Binary b(3); b <<= 64; assert(b.to_str() == "11" + std::string(64, '0')); b >>= 63; assert(b == Binary(6)); }
+
     assert(Binary(0).concat(Binary(0)) == Binary(0));
     assert(Binary(1).concat(Binary(0)) == Binary(2));
     assert(Binary(5).concat(Binary(5)) == Binary(45));
@@ -76,5 +157,1088 @@ int main() {
     assert(Binary(1) != Binary(0));
     assert(Binary(100) != Binary(101));
 
+    {
+        // numbers spanning multiple limbs
+        Binary a, b;
+        std::stringstream("1111111111111111111111111111111111111111111111111111111111111111111111") >> a;
+        std::stringstream("10000000000000000000000000000000000000000000000000000000000000000000000000000000000000011000000111001") >> b;
+        assert(a.to_str() == "1111111111111111111111111111111111111111111111111111111111111111111111");
+        assert(b.to_l() == 12345);
+        assert((a & b).to_str() == "11000000111001");
+        assert((a | b) > b);
+        assert(a < b);
+        assert(a != b);
+        assert(b.parity() == 7);
+        assert(b.concat(a).to_str() == b.to_str() + a.to_str());
+        assert(Binary(b).concat(a) == b.concat(a));
+        assert(Binary(a).concat(b).concat(a).to_str() == a.to_str() + b.to_str() + a.to_str());
+        assert(((b << 70) | a) == b.concat(a));
+        assert(((b << 131) >> 131) == b);
+        assert((b >> 40).to_str() == b.to_str().substr(0, 101 - 40));
+        assert(std::get<0>(b.div(a)).to_str() == "1000000000000000000000000000000");
+        assert(std::get<1>(b.div(a)).to_str() == "1000000000000000011000000111001");
+        assert((b + a - b) == a);
+        assert((b - a + a) == b);
+        assert((b - a).to_str() == "1111111111111111111111111111110000000000000000000000000000000000000000000000000000000011000000111010");
+
+        // the cached parity follows every modification
+        assert(b.concat(a).parity() == 77);
+        assert(b.parity() == 7);
+        b |= a;
+        assert(b.parity() == 71);
+        b ^= a;
+        assert(b.parity() == 1);
+        std::stringstream("111") >> b;
+        assert(b.parity() == 3);
+    }
+
+    {
+        // compound assignments and operators on rvalues reuse the left operand's limbs
+        const Binary a = Binary(~0ULL) << 500, b = (Binary(5) << 300) | Binary(3), c = Binary(~0ULL) << 200;
+        Binary d = a | c;
+        const std::size_t before = allocations;
+        d &= b;
+        d |= c;
+        d ^= a;
+        d += b;
+        d -= b;
+        d <<= 3;
+        d >>= 3;
+        d = (std::move(d) & b) | c;
+        Binary e = std::move(d) ^ a;
+        assert(allocations == before);
+        assert(e == ((((((((a | c) & b) | c) ^ a) & b) | c) ^ a)));
+        assert((Binary(12) & Binary(10)) == Binary(8) && (Binary(12) + Binary(10) - Binary(1)) == Binary(21));
+    }
+
+    {
+        // lazily evaluated expressions match their eager counterparts, including operands of different
+        // lengths, *empty* operands and targets that are operands themselves
+        const Binary a = (Binary(~0ULL) << 9000) | Binary(12345), b = Binary(~0ULL) << 4000, c = (Binary(5) << 7000) | Binary(7);
+        const Binary e, z(0);
+        Binary r = (lazy::ref(a) & b) ^ (lazy::ref(c) | e);
+        assert(r == ((a & b) ^ (c | e)));
+        r = lazy::ref(a) ^ c ^ b;
+        assert(r == (a ^ c ^ b));
+        r = (b | lazy::ref(c)) & a;
+        assert(r == ((b | c) & a));
+        assert(Binary(lazy::ref(e) & a) == (e & a) && Binary(lazy::ref(e) | e) == e && Binary(lazy::ref(z) & a) == z);
+
+        r = a;
+        const std::size_t before = allocations;
+        r = (lazy::ref(r) & c) | b;
+        r = lazy::ref(r) ^ a;
+        assert(allocations == before);
+        assert(r == (((a & c) | b) ^ a));
+    }
+
+    {
+        // limbs move between inline and heap storage transparently
+        LimbVector l { 1, 2 };
+        assert(l.is_inline() && l.size() == 2);
+        l.resize(LimbVector::INLINE_LIMBS + 1, 7);
+        assert(!l.is_inline() && l[1] == 2 && l.back() == 7);
+        LimbVector m(l), n { 3 };
+        assert(m == l && !m.is_inline());
+        n = std::move(m);
+        assert(n == l && m.empty());
+        m = LimbVector { 5 };
+        assert(m.is_inline() && m[0] == 5);
+
+        Binary b(5);
+        for (std::size_t i = 0; i < 10; i++) {
+            b = b.concat(Binary(~0ULL));
+        }
+        assert(b.to_str() == "101" + std::string(640, '1'));
+        assert(b.parity() == 642);
+        b >>= 600;
+        assert(b.to_str() == "101" + std::string(40, '1'));
+    }
+
+    {
+        // every kernel implementation agrees w/ the scalar one, including tails and length mismatches
+        const kernels::Isa isas[] = { kernels::Isa::Scalar, kernels::Isa::SSE2, kernels::Isa::AVX2, kernels::Isa::AVX512 };
+        const std::size_t sizes[] = { 1, 2, 3, 7, 8, 9, 16, 17, 31, 40, 130 };
+        for (const std::size_t limbs : sizes) {
+            std::string s1, s2;
+            for (std::size_t i = 0; i < limbs * 64; i++) {
+                s1.push_back((i * 7 + i / 3) % 5 < 2 ? '1' : '0');
+                if (i < limbs * 64 - 37) {
+                    s2.push_back((i * 11 + i / 5) % 3 ? '1' : '0');
+                }
+            }
+            Binary a, b;
+            std::stringstream(s1) >> a;
+            std::stringstream(s2) >> b;
+
+            kernels::use_isa(kernels::Isa::Scalar);
+            const Binary and_ = a & b, or_ = a | b, xor_ = a ^ b;
+            for (const kernels::Isa isa : isas) {
+                kernels::use_isa(isa);
+                assert((a & b) == and_ && (b & a) == and_);
+                assert((a | b) == or_ && (b | a) == or_);
+                assert((a ^ b) == xor_ && (b ^ a) == xor_);
+                assert(Binary(a).parity() + Binary(b).parity() == and_.parity() + or_.parity());
+                assert(Binary(a).parity() + Binary(b).parity() == 2 * and_.parity() + xor_.parity());
+            }
+        }
+        kernels::use_isa(kernels::detected_isa());
+    }
+
+    {
+        // every formatter agrees w/ the bit by bit representation, streamed output included
+        const kernels::Isa isas[] = { kernels::Isa::Scalar, kernels::Isa::SSE2, kernels::Isa::AVX2, kernels::Isa::AVX512 };
+        const std::size_t lengths[] = { 1, 63, 64, 65, 128, 129, 64 * 128, 64 * 128 + 1, 64 * 300 + 17 };
+        for (const std::size_t length : lengths) {
+            std::string s(1, '1');
+            for (std::size_t i = 1; i < length; i++) {
+                s.push_back((i * 7 + i / 3) % 5 < 2 ? '1' : '0');
+            }
+            const Binary b(s.data(), s.size());
+            for (const kernels::Isa isa : isas) {
+                kernels::use_isa(isa);
+                assert(b.to_str() == s);
+                std::stringstream ss;
+                ss << b;
+                assert(ss.str() == s);
+            }
+        }
+        kernels::use_isa(kernels::detected_isa());
+    }
+
+    {
+        // every literal parser agrees w/ the bit vector constructor and reports the first invalid character
+        const kernels::Isa isas[] = { kernels::Isa::Scalar, kernels::Isa::SSE2, kernels::Isa::AVX2, kernels::Isa::AVX512 };
+        const std::size_t lengths[] = { 1, 2, 63, 64, 65, 127, 128, 129, 300 };
+        for (const std::size_t length : lengths) {
+            std::string s;
+            std::vector<bool> bits;
+            for (std::size_t i = 0; i < length; i++) {
+                s.push_back((i * 7 + i / 3) % 5 < 2 ? '1' : '0');
+                bits.push_back(s.back() == '1');
+            }
+            for (const kernels::Isa isa : isas) {
+                kernels::use_isa(isa);
+                assert(Binary(s.data(), s.size()) == Binary(bits));
+                for (const std::size_t invalid : { std::size_t { 0 }, length / 2, length - 1 }) {
+                    std::string t = s;
+                    t[invalid] = '2';
+                    t[length - 1] = length > 1 && invalid != length - 1 ? 'x' : t[length - 1];
+                    bool thrown = false;
+                    try {
+                        Binary(t.data(), t.size());
+                    } catch (std::invalid_argument& e) {
+                        thrown = std::string(e.what()).find("found '2' at position " + std::to_string(invalid)) != std::string::npos;
+                    }
+                    assert(thrown);
+                }
+            }
+        }
+        kernels::use_isa(kernels::detected_isa());
+    }
+
+    {
+        // every multiplication algorithm yields the same products
+        std::string s1, s2;
+        for (std::size_t i = 0; i < 64 * 300; i++) {
+            s1.push_back((i * 7 + i / 3) % 5 < 2 ? '1' : '0');
+            s2.push_back(i % 64 == 5 || (i * 13) % 7 < 3 ? '1' : '0');
+        }
+        Binary a, b;
+        std::stringstream(s1) >> a;
+        std::stringstream(s2.substr(0, 64 * 170 + 9)) >> b;
+
+        const arith::MulThresholds defaults = arith::mul_thresholds;
+        const arith::MulThresholds tiers[] = {
+            { 1000, 1000, 1000 },   // schoolbook
+            { 8, 1000, 1000 },      // Karatsuba
+            { 8, 16, 1000 },        // Toom-3
+            { 8, 16, 64 },          // NTT
+        };
+        arith::mul_thresholds = tiers[0];
+        const Binary product = a * b, square = a * a;
+        assert(square + a == a * (a + Binary(1)));
+        for (const arith::MulThresholds &t : tiers) {
+            arith::mul_thresholds = t;
+            assert(a * b == product);
+            assert(b * a == product);
+            assert(a * a == square);
+            assert(b * b + b == b * (b + Binary(1)));
+        }
+        arith::mul_thresholds = defaults;
+    }
+
+    {
+        // Knuth's algorithm D and the Newton reciprocal division yield the same quotients and remainders
+        std::string s1, s2;
+        for (std::size_t i = 0; i < 64 * 90; i++) {
+            s1.push_back((i * 7 + i / 3) % 5 < 2 ? '1' : '0');
+            s2.push_back(i % 64 == 5 || (i * 13) % 7 < 3 ? '1' : '0');
+        }
+        Binary a, d;
+        std::stringstream("1" + s1) >> a;
+        std::stringstream("1" + s2.substr(0, 64 * 37 + 21)) >> d;
+
+        const std::size_t defaults = arith::div_threshold;
+        const Binary q = a / d, r = std::get<1>(a.div(d));
+        assert(q * d + r == a);
+        assert(r < d);
+        for (const std::size_t t : { std::size_t { 4 }, std::size_t { 16 } }) {
+            arith::div_threshold = t;
+            assert(a.div(d) == std::make_tuple(q, r));
+            assert((a * d).div(d) == std::make_tuple(a, Binary(0)));
+        }
+        arith::div_threshold = defaults;
+    }
+
+    {
+        // decimal conversion is exact for any width, through both the chunkwise and the divide and conquer path
+        assert(Binary().to_dec() == "");
+        assert(Binary(0).to_dec() == "0");
+        assert(Binary(666).to_dec() == "666");
+        assert(Binary::from_dec("000", 3) == Binary(0));
+        assert(Binary::from_dec("18446744073709551616", 20) == (Binary(1) << 64));
+        assert((Binary(1) << 64).to_dec() == "18446744073709551616");
+
+        Binary three(1);
+        for (int i = 0; i < 200; i++) {
+            three *= Binary(3);
+        }
+        const std::string power = "265613988875874769338781322035779626829233452653394495974574961739092490901302182994384699044001";
+        assert(three.to_dec() == power);
+        assert(Binary::from_dec(power.data(), power.size()) == three);
+
+        std::string digits;
+        for (std::size_t i = 0; i < 30000; i++) {
+            digits.push_back(static_cast<char>('1' + (i * 7 + i / 11) % 9));
+        }
+        const Binary wide = Binary::from_dec(digits.data(), digits.size());
+        assert(wide.to_dec() == digits);
+        assert((wide * Binary(10) + Binary(7)).to_dec() == digits + "7");
+
+        const std::size_t defaults = arith::div_threshold;
+        arith::div_threshold = 4;
+        assert(wide.to_dec() == digits);
+        arith::div_threshold = defaults;
+
+        bool thrown = false;
+        try {
+            Binary::from_dec("12a4", 4);
+        } catch (std::invalid_argument& e) {
+            thrown = std::string(e.what()).find("found 'a' at position 2") != std::string::npos;
+        }
+        assert(thrown);
+    }
+
+    {
+        // octal and hexadecimal conversion match the binary digits, across limb boundaries
+        assert(Binary().to_hex() == "");
+        assert(Binary(0).to_hex() == "0");
+        assert(Binary(0).to_oct() == "0");
+        assert(Binary(31).to_hex() == "1f");
+        assert(Binary(8).to_oct() == "10");
+        assert(Binary::from_hex("1F", 2) == Binary(31));
+        assert(Binary::from_oct("0017", 4) == Binary(15));
+        { std::stringstream ss; ss << std::hex << std::showbase << Binary(255) << ' ' << std::oct << Binary(8); assert(ss.str() == "0xff 0o10"); }
+
+        std::string bits;
+        for (std::size_t i = 0; i < 64 * 5 + 3 * 7; i++) {
+            bits.push_back((i * 5 + i / 7) % 3 ? '1' : '0');
+        }
+        bits[0] = '1';
+        const Binary wide(bits.data(), bits.size());
+        const std::string hex = wide.to_hex(), oct = wide.to_oct();
+        assert(hex.size() == (bits.size() + 3) / 4);
+        assert(oct.size() == (bits.size() + 2) / 3);
+        assert(Binary::from_hex(hex.data(), hex.size()) == wide);
+        assert(Binary::from_oct(oct.data(), oct.size()) == wide);
+        for (std::size_t d = 0; d < hex.size(); d++) {
+            const std::size_t shift = 4 * (hex.size() - 1 - d);
+            assert(hex[d] == "0123456789abcdef"[((wide >> shift) & Binary(15)).to_l()]);
+        }
+        for (std::size_t d = 0; d < oct.size(); d++) {
+            const std::size_t shift = 3 * (oct.size() - 1 - d);
+            assert(oct[d] == "01234567"[((wide >> shift) & Binary(7)).to_l()]);
+        }
+
+        for (const std::size_t invalid : { std::size_t { 0 }, std::size_t { 17 }, hex.size() - 1 }) {
+            std::string t = hex;
+            t[invalid] = 'g';
+            bool thrown = false;
+            try {
+                Binary::from_hex(t.data(), t.size());
+            } catch (std::invalid_argument& e) {
+                thrown = std::string(e.what()).find("found 'g' at position " + std::to_string(invalid)) != std::string::npos;
+            }
+            assert(thrown);
+        }
+        for (const char c : { '/', ':', '@', 'G', '`', 'g', '\x10', '\xe1' }) {
+            // characters next to the valid ranges, and ones that only become digits when folding case
+            std::string t = "0123456789abcdefABCDEF";
+            t[5] = c;
+            bool thrown = false;
+            try {
+                Binary::from_hex(t.data(), t.size());
+            } catch (std::invalid_argument& e) {
+                thrown = std::string(e.what()).find("at position 5") != std::string::npos;
+            }
+            assert(thrown);
+        }
+        bool thrown = false;
+        try {
+            Binary::from_oct("178", 3);
+        } catch (std::invalid_argument& e) {
+            thrown = std::string(e.what()).find("found '8' at position 2") != std::string::npos;
+        }
+        assert(thrown);
+
+        // octal digits are converted in groups of 3 limbs (64 digits), around and across their edges
+        const std::size_t widths[] = { 63, 64, 190, 191, 192, 193, 384, 385, 1000 };
+        for (const std::size_t width : widths) {
+            const std::size_t taken = std::min(width, bits.size());
+            const Binary b = Binary(bits.data(), taken) << (width - taken);
+            const std::string o = b.to_oct();
+            assert(o.size() == (width + 2) / 3);
+            assert(Binary::from_oct(o.data(), o.size()) == b);
+            assert(Binary::from_oct(("00" + o).data(), o.size() + 2) == b);
+        }
+        for (const char c : { '/', '8', '9', 'p', '\xb0' }) {
+            // characters next to the valid range, and ones that only match the low bits of a digit
+            for (const std::size_t invalid : { std::size_t { 0 }, std::size_t { 40 }, std::size_t { 60 }, oct.size() - 1 }) {
+                std::string t = oct;
+                t[invalid] = c;
+                bool invalid_thrown = false;
+                try {
+                    Binary::from_oct(t.data(), t.size());
+                } catch (std::invalid_argument& e) {
+                    invalid_thrown = std::string(e.what()).find("at position " + std::to_string(invalid)) != std::string::npos;
+                }
+                assert(invalid_thrown);
+            }
+        }
+    }
+
+    {
+        // archives round trip numbers of any width, their header and limbs are little endian
+        {
+            std::stringstream ss;
+            Binary(5).save(ss);
+            const std::string bytes = ss.str();
+            assert(bytes.size() == archive::HEADER_SIZE + 8);
+            assert(bytes.compare(0, 8, std::string("BNRY\x01\0\0\0", 8)) == 0);
+            assert(bytes.compare(8, 8, std::string("\x03\0\0\0\0\0\0\0", 8)) == 0);
+            assert(bytes.compare(24, 8, std::string("\x05\0\0\0\0\0\0\0", 8)) == 0);
+            assert(Binary::load(ss) == Binary(5));
+        }
+        std::string bits;
+        for (std::size_t i = 0; i < 64 * (archive::CHUNK_LIMBS + 100) + 17; i++) {
+            bits.push_back((i * 3 + i / 5) % 7 < 3 ? '1' : '0');
+        }
+        bits[0] = '1';
+        const Binary wide(bits.data(), bits.size());
+        for (const Binary& b : { Binary(), Binary(0), Binary(1) << 64, wide }) {
+            std::stringstream ss;
+            b.save(ss);
+            const Binary loaded = Binary::load(ss);
+            assert(loaded == b);
+            assert(loaded.to_str() == b.to_str());
+        }
+
+        // a writer that computes the checksum while the limbs are passed in chunks yields the same archive
+        std::stringstream whole, chunked;
+        wide.save(whole);
+        {
+            std::stringstream tmp;
+            wide.save(tmp);
+            archive::Reader reader(tmp);
+            archive::Writer writer(chunked, reader.bits());
+            std::uint64_t chunk[1000];
+            while (reader.remaining()) {
+                writer.write(chunk, reader.read(chunk, 1000));
+            }
+            writer.finish();
+        }
+        assert(whole.str() == chunked.str());
+
+        const std::string archived = whole.str();
+        const auto rejects = [](const std::string& bytes, const std::string& reason) {
+            std::stringstream ss(bytes);
+            try {
+                Binary::load(ss);
+            } catch (std::invalid_argument& e) {
+                return std::string(e.what()).find(reason) != std::string::npos;
+            }
+            return false;
+        };
+        std::string corrupt = archived;
+        corrupt[archive::HEADER_SIZE + 1000] ^= 4;
+        assert(rejects(corrupt, "checksum"));
+        assert(rejects(archived.substr(0, archived.size() - 1), "truncated"));
+        assert(rejects(archived.substr(0, 10), "truncated"));
+        assert(rejects("BNRZ" + archived.substr(4), "magic"));
+        assert(rejects(archived.substr(0, 4) + "\x02" + archived.substr(5), "version"));
+
+        const std::uint64_t limbs[2] = { 1, 2 };
+        std::stringstream ss;
+        archive::Writer writer(ss, 128);
+        writer.write(limbs, 2);
+        bool thrown = false;
+        try {
+            writer.write(limbs, 1);
+        } catch (std::length_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+    }
+
+    {
+        // views work on the mapped archive like Binary does on its limbs
+        std::string bits;
+        for (std::size_t i = 0; i < 64 * 300 + 41; i++) {
+            bits.push_back((i * 11 + i / 3) % 5 < 2 ? '1' : '0');
+        }
+        bits[0] = '1';
+        const Binary wide(bits.data(), bits.size()), other = wide * Binary(3);
+        const std::string path = std::string(P_tmpdir) + "/binary_view_test.bnry";
+        const std::string path2 = path + "2";
+        { std::ofstream os(path, std::ios::binary); wide.save(os); }
+        { std::ofstream os(path2, std::ios::binary); Binary(0).save(os); }
+
+        BinaryView view(path), zero(path2);
+        assert(view.verify());
+        assert(view.size() == bits.size());
+        assert(view == wide && wide == view && view != other);
+        assert(view < other && other > view && !(view > other));
+        assert(zero == Binary(0) && zero == Binary() && zero < view);
+        assert(view.parity() == wide.parity());
+        assert(view.to_l() == wide.to_l());
+        assert(view.to_binary() == wide);
+        assert((view & other) == (wide & other));
+        assert((other | view) == (other | wide));
+        assert((view ^ view) == Binary(0));
+        assert(Binary((lazy::ref(other) & view.ref()) ^ wide) == ((other & wide) ^ wide));
+        for (const std::size_t from : { std::size_t { 0 }, std::size_t { 5 }, std::size_t { 64 }, std::size_t { 64 * 299 + 3 }, bits.size() + 10 }) {
+            for (const std::size_t n : { std::size_t { 0 }, std::size_t { 1 }, std::size_t { 64 }, std::size_t { 130 } }) {
+                const Binary mask = n ? (Binary(1) << n) - Binary(1) : Binary(0);
+                const Binary slice = view.slice(from, n);
+                assert(slice == ((wide >> from) & mask));
+                assert(n || slice.to_str().empty());
+            }
+        }
+
+        BinaryView moved(std::move(view));
+        assert(moved == wide && view.size() == 0);
+
+        {
+            // a flipped limb goes unnoticed until the checksum is verified
+            std::fstream fs(path, std::ios::binary | std::ios::in | std::ios::out);
+            fs.seekp(static_cast<std::streamoff>(archive::HEADER_SIZE + 8 * 100));
+            fs.put('\x55');
+        }
+        assert(!BinaryView(path).verify());
+
+        bool thrown = false;
+        try {
+            std::ofstream(path, std::ios::binary) << "BNRY";
+            BinaryView truncated(path);
+        } catch (std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+        std::remove(path.c_str());
+        std::remove(path2.c_str());
+    }
+
+    {
+        // streamed operations on archives match their in-memory counterparts, over several chunks
+        const std::size_t defaults = stream::chunk_limbs;
+        stream::chunk_limbs = 7;
+        std::vector<Binary> operands { Binary(), Binary(0), Binary(1), Binary(~0ULL), Binary(1) << 64 };
+        for (const std::size_t length : { std::size_t { 1000 }, std::size_t { 64 * 30 + 5 }, std::size_t { 64 * 21 } }) {
+            std::string bits;
+            for (std::size_t i = 0; i < length; i++) {
+                bits.push_back((i * 13 + i / 7 + length) % 5 < 2 ? '1' : '0');
+            }
+            bits[0] = '1';
+            operands.push_back(Binary(bits.data(), bits.size()));
+        }
+        const std::string dir = std::string(P_tmpdir) + "/binary_stream_test_";
+        const auto path = [&dir](std::size_t i) { return dir + std::to_string(i) + ".bnry"; };
+        for (std::size_t i = 0; i < operands.size(); i++) {
+            std::ofstream os(path(i), std::ios::binary);
+            operands[i].save(os);
+        }
+        const auto load = [](const std::string& p) {
+            std::ifstream is(p, std::ios::binary);
+            return Binary::load(is);
+        };
+        const std::string out = dir + "out.bnry";
+        for (std::size_t i = 0; i < operands.size(); i++) {
+            const Binary& a = operands[i];
+            assert(stream::parity(path(i)) == a.parity());
+            for (std::size_t j = 0; j < operands.size(); j++) {
+                const Binary& b = operands[j];
+                stream::apply(stream::Bitwise::And, path(i), path(j), out);
+                assert(load(out) == (a & b));
+                stream::apply(stream::Bitwise::Or, path(i), path(j), out);
+                assert(load(out) == (a | b));
+                stream::apply(stream::Bitwise::Xor, path(i), path(j), out);
+                assert(load(out) == (a ^ b));
+                stream::concat(path(i), path(j), out);
+                assert(load(out) == a.concat(b));
+                const int c = stream::compare(path(i), path(j));
+                assert((c == 0) == (a == b) && (c < 0) == (a < b) && (c > 0) == (a > b));
+            }
+        }
+        for (std::size_t i = 0; i < operands.size(); i++) {
+            std::remove(path(i).c_str());
+        }
+        std::remove(out.c_str());
+
+        bool thrown = false;
+        try {
+            stream::parity(dir + "missing.bnry");
+        } catch (std::runtime_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+        stream::chunk_limbs = defaults;
+    }
+
+    {
+        // operations split across threads yield the results of their single threaded counterparts
+        const std::size_t threshold = parallel::threshold, chunk = parallel::chunk_limbs, threads = parallel::threads();
+        std::string s1, s2;
+        for (std::size_t i = 0; i < 64 * 203 + 9; i++) {
+            s1.push_back((i * 7 + i / 5) % 3 ? '1' : '0');
+            s2.push_back((i * 5 + i / 9) % 4 ? '0' : '1');
+        }
+        s1[0] = s2[0] = '1';
+        const Binary a(s1.data(), s1.size()), b(s2.data(), s2.size()), shorter = b >> 1000;
+
+        parallel::set_threads(1);
+        const Binary and_ab = a & b, or_ab = a | shorter, xor_ab = a ^ shorter;
+        const long parity = a.parity();
+
+        parallel::set_threads(4);
+        parallel::threshold = 8;
+        parallel::chunk_limbs = 5;
+        assert(parallel::threads() == 4 && parallel::worthwhile(8) && !parallel::worthwhile(7));
+        parallel::set_threads(999999);
+        assert(parallel::threads() == parallel::max_threads() && parallel::max_threads() >= 4);
+        parallel::set_threads(4);
+        assert((a & b) == and_ab && (a | shorter) == or_ab && (a ^ shorter) == xor_ab);
+        assert(Binary(s1.data(), s1.size()).parity() == parity);
+        assert(a == Binary(s1.data(), s1.size()) && a != b && !(a < a));
+        for (const std::size_t bit : { std::size_t { 0 }, std::size_t { 64 * 7 + 3 }, std::size_t { 64 * 100 }, s1.size() - 2 }) {
+            // a single differing bit in any chunk decides the comparison
+            std::string t = s1;
+            t[s1.size() - 1 - bit] = t[s1.size() - 1 - bit] == '1' ? '0' : '1';
+            const Binary c(t.data(), t.size());
+            assert(a != c && (a < c) == (t[s1.size() - 1 - bit] == '1') && (c < a) == (t[s1.size() - 1 - bit] == '0'));
+        }
+
+        std::vector<std::size_t> order;
+        parallel::set_threads(1);
+        parallel::for_each(4, [&order](std::size_t i) { order.push_back(i); });
+        assert((order == std::vector<std::size_t> { 0, 1, 2, 3 }));
+
+        parallel::threshold = threshold;
+        parallel::chunk_limbs = chunk;
+        parallel::set_threads(threads);
+    }
+
+    {
+        // products and quotients w/ sub-products split across threads match the single threaded ones
+        const std::size_t mul_threshold = parallel::mul_threshold, threads = parallel::threads();
+        const arith::MulThresholds defaults = arith::mul_thresholds;
+        const std::size_t div_threshold = arith::div_threshold;
+        std::string s1, s2;
+        for (std::size_t i = 0; i < 64 * 1200; i++) {
+            s1.push_back((i * 7 + i / 3) % 5 < 2 ? '1' : '0');
+            s2.push_back(i % 64 == 5 || (i * 13) % 7 < 3 ? '1' : '0');
+        }
+        s1[0] = s2[0] = '1';
+        const Binary a(s1.data(), s1.size()), b(s2.data(), 64 * 290 + 9);
+
+        const arith::MulThresholds tiers[] = {
+            { 8, 1000, 100000 },    // Karatsuba
+            { 8, 16, 100000 },      // Toom-3
+            { 8, 16, 64 },          // NTT
+        };
+        arith::div_threshold = 16;
+        for (const arith::MulThresholds &t : tiers) {
+            arith::mul_thresholds = t;
+            parallel::set_threads(1);
+            const Binary product = a * b, square = a * a;
+            const std::tuple<Binary, Binary> quotient = a.div(b);
+
+            parallel::set_threads(4);
+            parallel::mul_threshold = 8;
+            assert(a * b == product && b * a == product);
+            assert(a * a == square);
+            assert(a.div(b) == quotient);
+            assert(std::get<0>(quotient) * b + std::get<1>(quotient) == a);
+            parallel::mul_threshold = mul_threshold;
+        }
+        arith::mul_thresholds = defaults;
+        arith::div_threshold = div_threshold;
+        parallel::set_threads(threads);
+    }
+
+    {
+        // hashes are consistent w/ `==` and follow every modification, so binaries can key unordered containers
+        assert(Binary().hash() == Binary(0).hash() && std::hash<Binary>()(Binary(0)) == Binary(0).hash());
+        assert(Binary(0).hash() != Binary(1).hash());
+        assert(Binary("000101", 6).hash() == Binary(5).hash());
+        assert((Binary(1) << 300).hash() == Binary(("1" + std::string(300, '0')).data(), 301).hash());
+        assert((Binary(1) << 300).hash() != (Binary(1) << 301).hash());
+
+        Binary a(5);
+        const std::size_t five = a.hash();
+        a += Binary(1);
+        assert(a.hash() != five && a.hash() == Binary(6).hash());
+        a <<= 200;
+        assert(a.hash() == (Binary(6) << 200).hash());
+        a = a.concat(Binary(1));
+        assert(a.hash() == ((Binary(6) << 201) | Binary(1)).hash());
+
+        // cached hashes and parities only ever reject, equal values still compare equal
+        const Binary b(6), c(7);
+        b.hash();
+        c.parity();
+        assert(b == Binary(6) && b != c && c == Binary(7) && !(b == c));
+
+        std::unordered_set<Binary> set;
+        std::unordered_map<Binary, int> counts;
+        for (unsigned long long int i = 0; i < 2000; i++) {
+            set.insert(Binary(i % 500) << (i % 3 ? 0 : 100));
+            counts[Binary(i % 7)]++;
+        }
+        // `0 << 100` stays `0`, every other value occurs shifted and unshifted
+        assert(set.size() == 999 && set.count(Binary(499) << 100) && !set.count(Binary(500)));
+        assert(counts.size() == 7 && counts[Binary(3)] == 286 && counts.count(Binary()));
+    }
+
+    {
+        // fixed binaries are evaluated at compile time and match Binary at runtime
+        constexpr auto key = 1010_b;
+        static_assert(std::is_same<decltype(key), const FixedBinary<4>>::value, "a _b literal is as wide as its digits");
+        static_assert(std::is_same<decltype(1111'0000_b), FixedBinary<8>>::value, "digit separators are skipped");
+        static_assert((~key).to_l() == 5 && (~FixedBinary<64>()).parity() == 64, "NOT flips exactly N bits");
+        static_assert((key & 0110_b) == 0010_b && (key | 0110_b) == 1110_b && (key ^ 0110_b) == 1100_b, "");
+        static_assert(key.concat(~key) == 1010'0101_b && key.concat(1_b).to_l() == 21, "");
+        static_assert((key << 1) == 0100_b && (key >> 3) == 0001_b && (key << 4) == FixedBinary<4>(), "");
+        static_assert(0011_b < key && key > 0011_b && key != 0011_b, "");
+        static_assert(std::get<0>(FixedBinary<8>(200).div(7)) == 28 && std::get<1>(FixedBinary<8>(200).div(7)) == 4, "");
+
+        constexpr FixedBinary<130> top = FixedBinary<130>(1) << 129;
+        static_assert(top.parity() == 1 && (top >> 129) == 1 && (~top).parity() == 129, "");
+        static_assert(std::get<0>(top.div(FixedBinary<130>(3) << 64)).to_l() == 0xaaaaaaaaaaaaaaaaULL, "");
+
+        // conversions are lossless, widths w/o room for the value are rejected
+        const Binary b = (Binary(0xdeadbeefULL) << 100) | Binary(12345);
+        const FixedBinary<132> f(b);
+        assert(f.to_binary() == b && FixedBinary<200>(f).to_binary() == b);
+        assert(f.to_str() == b.to_str() && FixedBinary<140>(f).to_str() == std::string(8, '0') + b.to_str());
+        assert(key.to_binary() == Binary(10) && FixedBinary<8>(Binary()) == 0);
+        for (const Binary& d : { Binary(7), Binary(0xffffffffffffULL) << 30, b >> 3 }) {
+            const FixedBinary<132> fd(d);
+            const auto fixed = f.div(fd);
+            assert(std::make_tuple(std::get<0>(fixed).to_binary(), std::get<1>(fixed).to_binary()) == b.div(d));
+            assert(f / fd == FixedBinary<132>(b / d));
+            assert((f ^ fd).to_binary() == (b ^ d) && (f & fd).to_binary() == (b & d) && (f | fd).to_binary() == (b | d));
+            assert(f.concat(fd).to_binary() == ((b << 132) | d));
+        }
+        assert(f.parity() == b.parity() && (~f).parity() == 132 - b.parity());
+
+        bool thrown = false;
+        try {
+            FixedBinary<131> narrow(b);
+        } catch (const std::domain_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+        thrown = false;
+        try {
+            FixedBinary<4>("0012a", 5);
+        } catch (const std::invalid_argument& e) {
+            thrown = std::string(e.what()).find("found '2' at position 3") != std::string::npos;
+        }
+        assert(thrown);
+        thrown = false;
+        try {
+            f.div(FixedBinary<132>());
+        } catch (const std::domain_error&) {
+            thrown = true;
+        }
+        assert(thrown);
+        assert(FixedBinary<4>("0001010", 7) == key);
+    }
+
+    {
+        // constant expressions are evaluated at compile time, w/ the results and precedence of `evaluate`
+        constexpr auto mask = BINCALC("(101 . 11) & 11111");
+        static_assert(std::is_same<decltype(mask), const FixedBinary<5>>::value && mask == 10111_b, "");
+        static_assert(BINCALC("p 1011 == p 0b111") && !BINCALC("11 > 0x3") && BINCALC("p 0xff") == 8, "");
+        static_assert(BINCALC("1 . 0 << 11 == 10000") && BINCALC("1 1 0 1") == 1101_b, "");
+        constexpr auto quotient = BINCALC("0d1000 / 0o7");
+        static_assert(std::get<0>(quotient) == 10001110_b && std::get<1>(quotient) == 110_b, "");
+        static_assert(std::get<1>(BINCALC("101 / 111")) == 111_b, "");
+        static_assert(BINCALC("1 << 0d1000").size() == 1001 && BINCALC("0 . 0").size() == 1, "");
+
+        const std::string expressions[] = {
+            "(101 . 11) & 11111", "1 . 0 << 11", "0xff * 0d3 - 1 + 0o7", "11 ^ 110 | 1000", "p 0xdeadbeef",
+            "0 . 0 . 1", "111 >> 10 == 1", "p 101 < p 111", "1101 / 10", "1 != 1",
+            "101 / 111",
+        };
+        for (const std::string& expr : expressions) {
+            const Token expected = evaluate(expr);
+            char chars[32] = {};
+            std::copy(expr.begin(), expr.end(), chars);
+            const constant::Item value = constant::evaluate(chars);
+            assert(value.type == expected.type());
+            if (value.type == Token::Type::Bin) {
+                assert(FixedBinary<constant::MAX_BITS>(expected.bin()) == value.bin);
+                assert(!value.quotient || FixedBinary<constant::MAX_BITS>(expected.bin2()) == value.rem);
+            } else if (value.type == Token::Type::Num) {
+                assert(value.num == expected.num());
+            } else {
+                assert(value.boolean == expected.boolean());
+            }
+        }
+
+        // evaluated at runtime, errors are thrown like by `evaluate`
+        for (const char* expr : { "101 -", "(1", "1)", "p 1 & 1", "1 = 1", "1 - 11", "1 / 0", "0x" }) {
+            char chars[32] = {};
+            std::copy(expr, expr + std::strlen(expr), chars);
+            bool thrown = false;
+            try {
+                constant::evaluate(chars);
+            } catch (const std::invalid_argument&) {
+                thrown = true;
+            } catch (const std::domain_error&) {
+                thrown = true;
+            }
+            assert(thrown);
+        }
+    }
+
+    {
+        // once an arena has grown, evaluating on it does not touch the heap, memory outliving the scope
+        // is released safely
+        Arena arena(1 << 10);
+        const std::string exprs[] = {
+            "(101 & 011) . 1111 == 0b1011111 >> 1", "0x" + std::string(100, 'f') + " * 0d3 . 1 + 1", "p (1 << 0d1000)", "1101 / 10",
+        };
+        std::vector<Token> expected;
+        for (const std::string& expr : exprs) {
+            expected.push_back(evaluate(expr));
+        }
+        const Binary heap = Binary(~0ULL) << 1000;
+
+        {
+            Arena::Scope scope(arena);
+            for (const std::string& expr : exprs) {
+                evaluate(expr);
+            }
+        }
+        const std::size_t grown = arena.capacity();
+        assert(grown > 1 << 10);
+        arena.reset();
+
+        std::vector<Token> results;
+        results.reserve(4);
+        Binary outside = heap;
+        {
+            Arena::Scope scope(arena);
+            assert(arena::current() == &arena);
+            const std::size_t before = allocations;
+            for (std::size_t i = 0; i < 4; i++) {
+                results.push_back(evaluate(exprs[i]));
+            }
+            Binary copy = heap;
+            copy <<= 1000;
+            // heap storage released while an arena is installed still returns to the heap
+            outside <<= 3000;
+            assert(allocations == before);
+        }
+        assert(arena::current() == nullptr);
+        assert(arena.used() > 0 && arena.capacity() == grown);
+        for (std::size_t i = 0; i < 4; i++) {
+            assert(results[i].to_str() == expected[i].to_str());
+        }
+        results.clear();
+        outside = Binary();
+        arena.reset();
+        assert(arena.used() == 0);
+
+        // after a reset the blocks are reused, scopes nest
+        const std::size_t capacity = arena.capacity();
+        Arena inner;
+        {
+            Arena::Scope scope(arena);
+            {
+                Arena::Scope nested(inner);
+                assert(arena::current() == &inner && evaluate(exprs[2]).num() == 1);
+            }
+            assert(arena::current() == &arena && evaluate(exprs[1]).bin() == expected[1].bin());
+        }
+        assert(arena.capacity() == capacity);
+    }
+
+    {
+        // process-wide caches filled while an arena is installed survive its reset, 70000 digits need
+        // more powers of ten than the decimal conversions above
+        Binary ten(10), power(1);
+        for (std::size_t n = 70000; n; n >>= 1) {
+            if (n & 1) {
+                power *= ten;
+            }
+            ten *= ten;
+        }
+        Arena arena;
+        {
+            Arena::Scope scope(arena);
+            assert(power.to_dec() == "1" + std::string(70000, '0'));
+        }
+        arena.reset();
+        {
+            Arena::Scope scope(arena);
+            const Binary nines = power - Binary(1);
+            assert(nines.to_dec() == std::string(70000, '9'));
+            assert((nines << 1).to_dec() == "1" + std::string(69999, '9') + "8");
+        }
+        arena.reset();
+    }
+
+    {
+        // tokens are values, copies and moves keep the held value and switch between types
+        const Binary big = (Binary(~0ULL) << 500) | Binary(5);
+        Token a(big), b(Op::Add), c(Binary(7), Binary(1)), d(3L), e(true);
+        assert(a.type() == Token::Type::Bin && !a.has_bin2() && a.bin() == big);
+        assert(b.type() == Token::Type::Op && b.op() == Op::Add);
+        assert(c.has_bin2() && c.bin() == Binary(7) && c.bin2() == Binary(1) && c.to_str() == "111 R1 7 R1");
+        assert(d.num() == 3 && d.to_str() == "3" && e.boolean() && e.to_str() == "true");
+
+        Token f = a;
+        assert(f.bin() == big && a.bin() == big);
+        f = c;
+        assert(f.has_bin2() && f.bin2() == Binary(1));
+        f = d;
+        assert(f.type() == Token::Type::Num && f.num() == 3);
+        f = std::move(a);
+        const std::size_t before = allocations;
+        Token g = std::move(f);
+        const Binary moved = std::move(g).bin();
+        assert(allocations == before);
+        assert(moved == big);
+
+        const Token t = evaluate("(101 / 10) . 1");
+        assert(t.type() == Token::Type::Bin && !t.has_bin2() && t.bin() == Binary(5));
+        assert(evaluate("1101 / 10").to_str() == "110 R1 6 R1" && evaluate("p 111 == p 0d7").boolean());
+        std::ostringstream os;
+        os << std::hex << evaluate("p 0xfff") << ' ' << evaluate("11 < 10");
+        assert(os.str() == "12 false");
+
+        bool thrown = false;
+        try {
+            evaluate("1 == p 1");
+        } catch (const std::invalid_argument& err) {
+            thrown = std::string(err.what()) == "Cannot perform '==' on operands of type Binary and Number";
+        }
+        assert(thrown);
+    }
+
+    {
+        // prepared expressions match `evaluate` for every binding, reuse their storage and check
+        // syntax and types once when compiled
+        Program program("((a & b) . c) == ((a | c) << 0d3)");
+        assert(program.variables() == std::vector<std::string>({ "a", "b", "c" }));
+        Program bools("(x_val > y) != (p x_val == p y)");
+        Program arith("(x * y + y + 0o7 - y) >> 1 << 10 ^ x / 11");
+        Program quotient("x / y");
+        Program shift("x << y");
+        assert(bools.variables() == std::vector<std::string>({ "x_val", "y" }) && program.index("c") == 2);
+
+        const Binary values[] = { Binary(0), Binary(5), Binary(12), Binary(255), (Binary(~0ULL) << 300) | Binary(3) };
+        for (const Binary& x : values) {
+            for (const Binary& y : values) {
+                program.bind("a", x);
+                program.bind(1, y);
+                program.bind(2, x ^ y);
+                assert(program.run().boolean() == evaluate("((" + x.to_str() + " & " + y.to_str() + ") . " + (x ^ y).to_str() + ") == ((" + x.to_str() + " | " + (x ^ y).to_str() + ") << 0d3)").boolean());
+                bools.bind(0, x);
+                bools.bind(1, y);
+                assert(bools.run().to_str() == evaluate("(" + x.to_str() + " > " + y.to_str() + ") != (p " + x.to_str() + " == p " + y.to_str() + ")").to_str());
+                arith.bind(0, x);
+                arith.bind(1, y);
+                assert(arith.run().to_str() == evaluate("(" + x.to_str() + " * " + y.to_str() + " + " + y.to_str() + " + 0o7 - " + y.to_str() + ") >> 1 << 10 ^ " + x.to_str() + " / 11").to_str());
+                quotient.bind(0, x);
+                quotient.bind(1, y);
+                if (y == Binary(0)) {
+                    bool thrown = false;
+                    try {
+                        quotient.run();
+                    } catch (const std::domain_error&) {
+                        thrown = true;
+                    }
+                    assert(thrown);
+                } else {
+                    const Token t = quotient.run();
+                    assert(t.has_bin2() && t.to_str() == evaluate(x.to_str() + " / " + y.to_str()).to_str());
+                }
+            }
+        }
+
+        // once the stacks have grown to the operands, runs do not allocate besides the result
+        const Binary big = (Binary(~0ULL) << 900) | Binary(7);
+        program.bind(0, big);
+        program.bind(1, big);
+        program.bind(2, big);
+        program.run();
+        const std::size_t before = allocations;
+        assert(!program.run().boolean());
+        assert(allocations == before);
+
+        shift.bind(0, Binary(1));
+        shift.bind(1, Binary(std::numeric_limits<std::size_t>::max()) << 1);
+        bool thrown = false;
+        try {
+            shift.run();
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        for (const char* expr : { "a & p b", "(a", "a +", "a b", "p (a == b)", "a % b" }) {
+            thrown = false;
+            try {
+                Program invalid(expr);
+            } catch (const std::invalid_argument&) {
+                thrown = true;
+            }
+            assert(thrown);
+        }
+        // unmatched parentheses are reported, not read past the operator stack
+        for (const char* expr : { "1)", "(1))", ") 1" }) {
+            thrown = false;
+            try {
+                evaluate(expr);
+            } catch (const std::invalid_argument&) {
+                thrown = true;
+            }
+            assert(thrown);
+        }
+        thrown = false;
+        try {
+            Program invalid("a)");
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+
+        thrown = false;
+        try {
+            Program("a . b").run();
+        } catch (const std::invalid_argument& e) {
+            thrown = std::string(e.what()) == "Variable 'a' is not bound";
+        }
+        assert(thrown);
+
+        // variables are only part of prepared expressions, literals are parsed like in expressions
+        thrown = false;
+        try {
+            evaluate("a & 1");
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        assert(thrown);
+        assert(literal("0x1f", 4) == Binary(31) && literal("101", 3) == Binary(5) && literal("0d7", 3) == Binary(7));
+    }
+
+    {
+        // const binaries may be read by several threads at once, their caches are filled concurrently
+        std::unordered_set<Binary> set;
+        std::vector<Binary> keys;
+        for (unsigned long i = 0; i < 64; i++) {
+            keys.push_back((Binary(i) << 300) | Binary(i));
+        }
+        for (const Binary& k : keys) {
+            set.insert(Binary(k.to_str().data(), k.to_str().size()));
+        }
+        std::atomic<std::size_t> found { 0 };
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; t++) {
+            readers.emplace_back([&]() {
+                for (const Binary& k : keys) {
+                    found += set.count(k) + static_cast<std::size_t>(k.parity() >= 0);
+                }
+            });
+        }
+        for (std::thread& reader : readers) {
+            reader.join();
+        }
+        assert(found == 4 * 2 * keys.size());
+    }
+
+    {
+        // binaries are read from streams block by block, across block boundaries and w/ errors
+        // reported at their position within the token
+        std::string digits(64 * 64 * 3 + 17, '0');
+        for (std::size_t i = 0; i < digits.size(); i += 7) {
+            digits[i] = '1';
+        }
+        digits[0] = '1';
+        for (std::size_t len : { std::size_t { 1 }, std::size_t { 64 * 64 }, std::size_t { 64 * 64 + 1 }, digits.size() }) {
+            const std::string token = digits.substr(0, len);
+            std::stringstream ss("  " + token + "\n101 ");
+            Binary b, c;
+            ss >> b >> c;
+            assert(b == Binary(token.data(), token.size()) && c == Binary(5) && !ss.eof());
+        }
+        std::string invalid = digits;
+        invalid[64 * 64 + 5] = '2';
+        bool thrown = false;
+        try {
+            Binary b;
+            std::stringstream(invalid) >> b;
+        } catch (const std::invalid_argument& e) {
+            thrown = std::string(e.what()) == "Binary string representation must only contain '0' or '1', found '2' at position " + std::to_string(64 * 64 + 5);
+        }
+        assert(thrown);
+        Binary e(3);
+        std::stringstream empty("   ");
+        empty >> e;
+        assert(empty.fail() && e.to_str() == "");
+    }
+
+    {
+        // hexadecimal and octal output is written chunk by chunk, w/o a string of the full width
+        const Binary big = (Binary(0x123456789abcdefULL) << 300000) | (Binary(~0ULL) << 1000) | Binary(7);
+        for (std::ios::fmtflags base : { std::ios::hex, std::ios::oct }) {
+            std::ostringstream os;
+            os.setf(base, std::ios::basefield);
+            os << std::showbase << big << ' ' << Binary(0) << ' ' << Binary() << '.';
+            const std::string digits = base == std::ios::hex ? big.to_hex() : big.to_oct();
+            assert(os.str() == (base == std::ios::hex ? "0x" : "0o") + digits + (base == std::ios::hex ? " 0x0 ." : " 0o0 ."));
+        }
+
+        struct Discard : std::streambuf {
+            std::size_t written = 0;
+            std::streamsize xsputn(const char*, std::streamsize n) override {
+                written += static_cast<std::size_t>(n);
+                return n;
+            }
+        } discard;
+        std::ostream os(&discard);
+        os << std::hex;
+        const std::size_t before = allocations;
+        os << big;
+        os << std::oct << big;
+        assert(allocations == before);
+        assert(discard.written == big.to_hex().size() + big.to_oct().size());
+    }
+
     return 0;
 }